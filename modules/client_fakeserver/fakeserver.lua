@@ -0,0 +1,602 @@
+-- login and game server stand-in running inside the client, to load test the
+-- network and rendering paths locally. start it with the -fake-server startup
+-- option or from the terminal, e.g. modules.client_fakeserver.start({ creatures = 300, latency = 80, jitter = 20 }),
+-- then log in to 127.0.0.1:7171 with any account using the OTServ RSA key.
+
+local ClientEnterAccount = 1
+local ClientPendingGame = 10
+local ClientLeaveGame = 20
+local ClientPing = 29
+local ClientChangeMapAwareRange = 51
+local ClientAutoWalk = 100
+local ClientStop = 105
+
+local LoginServerCharacterList = 100
+local GameServerChallenge = 31
+local GameServerChangeMapAwareRange = 51
+
+local WalkDirections = {
+  [101] = Directions.North,
+  [102] = Directions.East,
+  [103] = Directions.South,
+  [104] = Directions.West,
+  [106] = Directions.NorthEast,
+  [107] = Directions.SouthEast,
+  [108] = Directions.SouthWest,
+  [109] = Directions.NorthWest
+}
+
+local TurnDirections = {
+  [111] = Directions.North,
+  [112] = Directions.East,
+  [113] = Directions.South,
+  [114] = Directions.West
+}
+
+local AutoWalkDirections = {
+  [1] = Directions.East,
+  [2] = Directions.NorthEast,
+  [3] = Directions.North,
+  [4] = Directions.NorthWest,
+  [5] = Directions.West,
+  [6] = Directions.SouthWest,
+  [7] = Directions.South,
+  [8] = Directions.SouthEast
+}
+
+-- private half of OTSERV_RSA, the key clients use by default
+local OtservRsaP = '14299623962416399520070177382898895550795403345466153217470516082934737582776038882967213386204600674145392845853859217990626450972452084065728686565928113'
+local OtservRsaQ = '7630979195970404721891201847792002125535401292779123937207447574596692788513647179235335529307251350570728407373705564708871762033017096809910315212884101'
+local OtservRsaD = '46730330223584118622160180015036832148732986808519344675210555262940258739805766860224610646919605860206328024326703361630109888417839241959507572247284807035235569619173792292786907845791904955103601652822519121908367187885509270025388641700821735345222087940578381210879116823013776808975766851829020659073'
+
+local defaultOptions = {
+  host = '127.0.0.1', -- game server address given in the character list
+  loginPort = 7171,
+  gamePort = 7172,
+  worldName = 'Fake',
+  characterName = 'Fake Player',
+  position = { x = 1000, y = 1000, z = 7 },
+  groundId = 0, -- 0 uses the first ground of the loaded things
+  playerOutfit = 128,
+  playerSpeed = 220,
+  playerStepInterval = 300,
+  creatures = 50,
+  creatureOutfits = { 128, 129, 130, 131, 132, 133, 134 },
+  creatureSpeed = 220,
+  walkInterval = 1000,
+  effectsPerSecond = 0,
+  effects = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20 },
+  tickInterval = 50,
+  latency = 0, -- ms added to every message sent to the client
+  jitter = 0, -- ms of random variation on top of the latency
+  record = nil, -- packet record streamed instead of the synthetic world
+  recordSpeed = 1 -- 0 streams the record as fast as possible
+}
+
+local options
+local loginServer
+local gameServer
+local recordPlayer
+-- a list, objects are pushed as new userdata each time so they can't be table keys
+local sessions = {}
+local gameSession
+
+FakeSession = extends(Protocol, 'FakeSession')
+
+function FakeSession:setup(connection)
+  self.queue = {}
+  self.queueHead = 1
+  self.queueTail = 0
+  self.lastDue = 0
+  self:setConnection(connection)
+  table.insert(sessions, self)
+
+  if g_game.getFeature(GameProtocolChecksum) then
+    self:enableChecksum()
+  end
+end
+
+-- messages are held back by the latency and jitter, keeping their order like tcp does
+function FakeSession:sendMessage(msg)
+  if options.latency <= 0 and options.jitter <= 0 then
+    self:send(msg)
+    return
+  end
+
+  local now = g_clock.millis()
+  local due = math.max(self.lastDue, now + options.latency + math.random(-options.jitter, options.jitter))
+  self.lastDue = due
+
+  self.queueTail = self.queueTail + 1
+  self.queue[self.queueTail] = { due = due, msg = msg }
+  if not self.flushEvent then
+    self.flushEvent = scheduleEvent(function() self:flushQueue() end, due - now)
+  end
+end
+
+function FakeSession:flushQueue()
+  self.flushEvent = nil
+
+  local now = g_clock.millis()
+  while self.queueHead <= self.queueTail do
+    local entry = self.queue[self.queueHead]
+    if entry.due > now then
+      self.flushEvent = scheduleEvent(function() self:flushQueue() end, entry.due - now)
+      return
+    end
+
+    self.queue[self.queueHead] = nil
+    self.queueHead = self.queueHead + 1
+    if self:isConnected() then
+      self:send(entry.msg)
+    end
+  end
+end
+
+function FakeSession:readLoginBlock(msg)
+  if not g_game.getFeature(GameLoginPacketEncryption) then
+    msg:getU8() -- first byte, always 0
+    return true
+  end
+
+  g_crypt.rsaSetPrivateKey(OtservRsaP, OtservRsaQ, OtservRsaD)
+  if not msg:decryptRsa(g_crypt.rsaGetSize()) then
+    g_logger.error('Fake server: the login packet was not encrypted with the OTServ RSA key')
+    return false
+  end
+
+  self:setXteaKey(msg:getU32(), msg:getU32(), msg:getU32(), msg:getU32())
+  return true
+end
+
+function FakeSession:onError(message, code)
+  self:close()
+end
+
+function FakeSession:close()
+  removeEvent(self.flushEvent)
+  self.flushEvent = nil
+  table.removevalue(sessions, self)
+  self:disconnect()
+end
+
+FakeLoginSession = extends(FakeSession, 'FakeLoginSession')
+
+function FakeLoginSession:onRecv(msg)
+  if msg:getU8() ~= ClientEnterAccount then
+    self:close()
+    return
+  end
+
+  msg:getU16() -- os
+  msg:getU16() -- protocol version
+  if g_game.getFeature(GameClientVersion) then
+    msg:getU32()
+  end
+
+  if g_game.getFeature(GameContentRevision) then
+    msg:getU16()
+    msg:getU16()
+  else
+    msg:getU32() -- dat signature
+  end
+  msg:getU32() -- spr signature
+  msg:getU32() -- pic signature
+
+  if g_game.getFeature(GamePreviewState) then
+    msg:getU8()
+  end
+
+  -- any account and password are accepted
+  if g_game.getFeature(GameLoginPacketEncryption) then
+    if not self:readLoginBlock(msg) then
+      self:close()
+      return
+    end
+    self:enableXteaEncryption()
+  end
+
+  self:sendCharacterList()
+end
+
+function FakeLoginSession:sendCharacterList()
+  local characterName = options.characterName
+  local worldName = options.worldName
+  if recordPlayer then
+    characterName = recordPlayer:getCharacterName()
+    worldName = recordPlayer:getWorldName()
+  end
+
+  local msg = OutputMessage.create()
+  msg:addU8(LoginServerCharacterList)
+
+  if g_game.getClientVersion() > 1010 then
+    msg:addU8(1) -- worlds
+    msg:addU8(0) -- world id
+    msg:addString(worldName)
+    msg:addString(options.host)
+    msg:addU16(options.gamePort)
+    msg:addU8(0) -- preview state
+
+    msg:addU8(1) -- characters
+    msg:addU8(0) -- world id
+    msg:addString(characterName)
+  else
+    msg:addU8(1) -- characters
+    msg:addString(characterName)
+    msg:addString(worldName)
+    msg:addU32(stringtoip(options.host))
+    msg:addU16(options.gamePort)
+    if g_game.getFeature(GamePreviewState) then
+      msg:addU8(0)
+    end
+  end
+
+  if g_game.getProtocolVersion() > 1077 then
+    msg:addU8(AccountStatus.Ok)
+    msg:addU8(SubscriptionStatus.Premium)
+    msg:addU32(65535) -- premium days, 65535 never expires
+  else
+    msg:addU16(65535)
+  end
+
+  self:sendMessage(msg)
+end
+
+FakeGameSession = extends(FakeSession, 'FakeGameSession')
+
+function FakeGameSession:setup(connection)
+  FakeSession.setup(self, connection)
+  self.firstMessage = true
+  self.autoWalkSteps = {}
+
+  if g_game.getFeature(GamePacketCompression) then
+    self:enableCompression()
+    self:enableOutputCompression()
+  end
+
+  if g_game.getFeature(GameChallengeOnLogin) then
+    local msg = self:createMessage()
+    msg:addU8(GameServerChallenge)
+    msg:addU32(os.time())
+    msg:addU8(math.random(0, 0xFF))
+    self:sendMessage(msg)
+  end
+end
+
+-- the first message the client reads is prefixed with its size on newer protocols
+function FakeGameSession:createMessage()
+  local msg = OutputMessage.create()
+  if self.firstMessage and g_game.getFeature(GameMessageSizeCheck) then
+    msg:addU16(0)
+    self.sizeFirstMessage = true
+  end
+  self.firstMessage = false
+  return msg
+end
+
+function FakeGameSession:sendMessage(msg)
+  if self.sizeFirstMessage then
+    self.sizeFirstMessage = false
+    local messageSize = msg:getMessageSize()
+    local writePos = msg:getWritePos()
+    msg:setWritePos(writePos - messageSize)
+    msg:addU16(messageSize - 2)
+    msg:setWritePos(writePos)
+    msg:setMessageSize(messageSize)
+  end
+
+  FakeSession.sendMessage(self, msg)
+end
+
+function FakeGameSession:onRecv(msg)
+  local opcode = msg:getU8()
+  if not self.loggedIn then
+    if opcode == ClientPendingGame then
+      self:parseLogin(msg)
+    else
+      self:close()
+    end
+  elseif opcode == ClientLeaveGame then
+    self:close()
+  elseif opcode == ClientPing then
+    local reply = self:createMessage()
+    if g_game.getFeature(GameClientPing) then
+      reply:addU8(GameServerOpcodes.GameServerPing)
+    else
+      reply:addU8(GameServerOpcodes.GameServerPingBack)
+    end
+    self:sendMessage(reply)
+  elseif not recordPlayer then
+    self:parseWorldAction(opcode, msg)
+  end
+
+  -- the rest of the message is ignored, game actions have no answer here
+  if self:isConnected() then
+    self:recv()
+  end
+end
+
+function FakeGameSession:parseLogin(msg)
+  msg:getU16() -- os
+  msg:getU16() -- protocol version
+  if g_game.getFeature(GameClientVersion) then
+    msg:getU32()
+  end
+
+  if g_game.getFeature(GameContentRevision) then
+    msg:getU16()
+  end
+
+  if g_game.getFeature(GamePreviewState) then
+    msg:getU8()
+  end
+
+  if not self:readLoginBlock(msg) then
+    self:close()
+    return
+  end
+
+  local characterName
+  if g_game.getFeature(GameLoginPacketEncryption) then
+    msg:getU8() -- is gm set
+  end
+
+  if g_game.getFeature(GameSessionKey) then
+    msg:getString()
+    characterName = msg:getString()
+  else
+    if g_game.getFeature(GameAccountNames) then
+      msg:getString()
+    else
+      msg:getU32()
+    end
+    characterName = msg:getString()
+  end
+
+  if g_game.getFeature(GameLoginPacketEncryption) then
+    self:enableXteaEncryption()
+  end
+
+  -- the world follows a single player, a new login takes it over
+  if gameSession and gameSession ~= self then
+    gameSession:close()
+  end
+  gameSession = self
+  self.loggedIn = true
+
+  if recordPlayer then
+    self:startRecord()
+    return
+  end
+
+  createWorld(options, characterName)
+
+  local msg = self:createMessage()
+  addLogin(msg)
+  addMapDescription(msg)
+  addWorldLight(msg)
+  self:sendMessage(msg)
+
+  self.lastTick = g_clock.millis()
+  self.tickEvent = cycleEvent(function() self:tick() end, options.tickInterval)
+end
+
+function FakeGameSession:parseWorldAction(opcode, msg)
+  if WalkDirections[opcode] then
+    self.autoWalkSteps = {}
+    self:walk(WalkDirections[opcode])
+  elseif TurnDirections[opcode] then
+    local reply = self:createMessage()
+    addPlayerTurn(reply, TurnDirections[opcode])
+    self:sendMessage(reply)
+  elseif opcode == ClientAutoWalk then
+    self.autoWalkSteps = {}
+    local count = msg:getU8()
+    for i = 1, count do
+      local direction = AutoWalkDirections[msg:getU8()]
+      if direction then
+        table.insert(self.autoWalkSteps, direction)
+      end
+    end
+    self:autoWalk()
+  elseif opcode == ClientStop then
+    self.autoWalkSteps = {}
+  elseif opcode == ClientChangeMapAwareRange then
+    local xrange = msg:getU8()
+    local yrange = msg:getU8()
+    setAwareRange(xrange, yrange)
+
+    local reply = self:createMessage()
+    reply:addU8(GameServerChangeMapAwareRange)
+    reply:addU8(xrange)
+    reply:addU8(yrange)
+    addMapDescription(reply)
+    self:sendMessage(reply)
+  end
+end
+
+function FakeGameSession:walk(direction)
+  local msg = self:createMessage()
+  addPlayerWalk(msg, direction)
+  self:sendMessage(msg)
+end
+
+function FakeGameSession:autoWalk()
+  removeEvent(self.autoWalkEvent)
+  self.autoWalkEvent = nil
+
+  local direction = table.remove(self.autoWalkSteps, 1)
+  if not direction then
+    return
+  end
+
+  self:walk(direction)
+  if #self.autoWalkSteps > 0 then
+    self.autoWalkEvent = scheduleEvent(function() self:autoWalk() end, options.playerStepInterval)
+  end
+end
+
+function FakeGameSession:tick()
+  local now = g_clock.millis()
+  local msg = self:createMessage()
+  if addWorldTick(msg, now - self.lastTick) then
+    self:sendMessage(msg)
+  end
+  self.lastTick = now
+end
+
+function FakeGameSession:startRecord()
+  self.recordIndex = 0
+  self.recordStart = g_clock.millis()
+
+  -- the client already got a challenge from us, the recorded one would make it log in again
+  local packet = recordPlayer:getPacket(0)
+  local opcodePos = g_game.getFeature(GameMessageSizeCheck) and 3 or 1
+  if g_game.getFeature(GameChallengeOnLogin) and packet:byte(opcodePos) == GameServerChallenge then
+    self.recordIndex = 1
+  end
+
+  self:streamRecord()
+end
+
+function FakeGameSession:streamRecord()
+  self.recordEvent = nil
+
+  local sliceStart = g_clock.millis()
+  local elapsed = (sliceStart - self.recordStart) * options.recordSpeed
+  local count = recordPlayer:getPacketCount()
+  while self.recordIndex < count do
+    if options.recordSpeed > 0 then
+      local time = recordPlayer:getPacketTime(self.recordIndex)
+      if time > elapsed then
+        self.recordEvent = scheduleEvent(function() self:streamRecord() end, (time - elapsed) / options.recordSpeed)
+        return
+      end
+    elseif g_clock.millis() - sliceStart >= 10 then
+      -- at max speed the record is streamed in slices, so frames still get rendered
+      self.recordEvent = scheduleEvent(function() self:streamRecord() end, 1)
+      return
+    end
+
+    -- recorded messages already carry the size prefix when the protocol has one
+    local msg = OutputMessage.create()
+    msg:setBuffer(recordPlayer:getPacket(self.recordIndex))
+    self.firstMessage = false
+    self.recordIndex = self.recordIndex + 1
+    self:sendMessage(msg)
+  end
+end
+
+function FakeGameSession:close()
+  removeEvent(self.tickEvent)
+  removeEvent(self.autoWalkEvent)
+  removeEvent(self.recordEvent)
+  self.tickEvent = nil
+  self.autoWalkEvent = nil
+  self.recordEvent = nil
+
+  if gameSession == self then
+    gameSession = nil
+    destroyWorld()
+  end
+
+  FakeSession.close(self)
+end
+
+local function createServer(port, sessionClass)
+  local server = Server.create(port)
+  if not server then
+    return nil
+  end
+
+  server.onAccept = function(server, connection, errorMessage, errorCode)
+    if errorCode ~= 0 then
+      if server:isOpen() then
+        g_logger.error('Fake server: failed to accept a connection: ' .. errorMessage)
+        server:acceptNext()
+      end
+      return
+    end
+
+    server:acceptNext()
+
+    local session = sessionClass.create()
+    session:setup(connection)
+    session:recv()
+  end
+  server:acceptNext()
+  return server
+end
+
+function init()
+  if g_app.getStartupOptions():find('-fake-server', 1, true) then
+    start()
+  end
+end
+
+function terminate()
+  stop()
+end
+
+function start(customOptions)
+  stop()
+
+  options = table.recursivecopy(defaultOptions)
+  table.merge(options, customOptions or {})
+
+  if options.record then
+    local ok, player = pcall(PacketPlayer.create, options.record)
+    if not ok then
+      g_logger.error('Fake server: ' .. tostring(player))
+      return false
+    end
+    recordPlayer = player
+
+    if recordPlayer:getProtocolVersion() ~= g_game.getProtocolVersion() then
+      g_logger.warning(string.format('Fake server: record was made with protocol %d, the client is set to %d',
+                                     recordPlayer:getProtocolVersion(), g_game.getProtocolVersion()))
+    end
+  end
+
+  loginServer = createServer(options.loginPort, FakeLoginSession)
+  gameServer = createServer(options.gamePort, FakeGameSession)
+  if not loginServer or not gameServer then
+    stop()
+    return false
+  end
+
+  g_logger.info(string.format('Fake server: login on %s:%d, game on port %d', options.host, options.loginPort, options.gamePort))
+  return true
+end
+
+function stop()
+  if loginServer then
+    loginServer:close()
+    loginServer = nil
+  end
+
+  if gameServer then
+    gameServer:close()
+    gameServer = nil
+  end
+
+  for _, session in ipairs(table.copy(sessions)) do
+    session:close()
+  end
+  sessions = {}
+  gameSession = nil
+  recordPlayer = nil
+end
+
+function isRunning()
+  return loginServer ~= nil
+end
+
+function setLatency(latency, jitter)
+  if not options then
+    return
+  end
+  options.latency = latency or 0
+  options.jitter = jitter or 0
+end
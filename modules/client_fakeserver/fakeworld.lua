@@ -0,0 +1,481 @@
+-- synthetic world of the fake server: an endless ground floor,
+-- creatures wandering around the player and magic effects
+
+local PlayerId = 0x10000001
+local CreatureStartId = 0x40000001
+
+local LoginOrPendingState = 10
+local LoginSuccess = 23
+
+local UnknownCreature = 0x61
+local KnownCreature = 0x63
+local CreatureTypePlayer = 0
+local CreatureTypeMonster = 1
+
+local SeaFloor = 7
+local MaxZ = 15
+local AwareUndergroundFloorRange = 2
+local MaxCreaturesPerTile = 8
+
+local DirectionOffsets = {
+  [Directions.North] = { x = 0, y = -1 },
+  [Directions.East] = { x = 1, y = 0 },
+  [Directions.South] = { x = 0, y = 1 },
+  [Directions.West] = { x = -1, y = 0 },
+  [Directions.NorthEast] = { x = 1, y = -1 },
+  [Directions.SouthEast] = { x = 1, y = 1 },
+  [Directions.SouthWest] = { x = -1, y = 1 },
+  [Directions.NorthWest] = { x = -1, y = -1 }
+}
+
+local world
+
+local function tileKey(x, y)
+  return x * 65536 + y
+end
+
+local function findGround(groundId)
+  if groundId and groundId > 0 then
+    return groundId
+  end
+
+  -- the first ground of the loaded things
+  local grounds = g_things.findThingTypeByAttr(ThingAttrGround, ThingCategoryItem)
+  if #grounds > 0 then
+    return grounds[1]:getId()
+  end
+  return 100
+end
+
+local function isAware(x, y)
+  local center, range = world.center, world.range
+  return x >= center.x - range.left and x <= center.x + range.right and
+         y >= center.y - range.top and y <= center.y + range.bottom
+end
+
+-- creatures wander a bit inside the aware area, so they stay visible
+local function isInsideBox(x, y)
+  local center, range = world.center, world.range
+  return x >= center.x - range.left + 1 and x <= center.x + range.right - 1 and
+         y >= center.y - range.top + 1 and y <= center.y + range.bottom - 1
+end
+
+local function getTileCreatures(x, y)
+  return world.tiles[tileKey(x, y)]
+end
+
+local function placeCreature(creature, x, y)
+  if creature.pos then
+    local tile = getTileCreatures(creature.pos.x, creature.pos.y)
+    table.removevalue(tile, creature)
+    if #tile == 0 then
+      world.tiles[tileKey(creature.pos.x, creature.pos.y)] = nil
+    end
+  end
+
+  local key = tileKey(x, y)
+  local tile = world.tiles[key]
+  if not tile then
+    tile = {}
+    world.tiles[key] = tile
+  end
+  table.insert(tile, creature)
+  creature.pos = { x = x, y = y, z = world.center.z }
+end
+
+local function canStand(x, y)
+  local tile = getTileCreatures(x, y)
+  return not tile or #tile < MaxCreaturesPerTile
+end
+
+local function randomFreePosition()
+  local center, range = world.center, world.range
+  for i = 1, 100 do
+    local x = math.random(center.x - range.left + 1, center.x + range.right - 1)
+    local y = math.random(center.y - range.top + 1, center.y + range.bottom - 1)
+    if canStand(x, y) and (x ~= center.x or y ~= center.y) then
+      return x, y
+    end
+  end
+  return center.x + 1, center.y
+end
+
+local function addPosition(msg, x, y, z)
+  msg:addU16(x)
+  msg:addU16(y)
+  msg:addU8(z)
+end
+
+local function addDouble(msg, value, precision)
+  msg:addU8(precision)
+  msg:addU32(math.floor(value * math.pow(10, precision) + 0.5) + 0x7FFFFFFF)
+end
+
+local function addItem(msg, id)
+  msg:addU16(id)
+
+  if g_game.getFeature(GameThingMarks) then
+    msg:addU8(0xFF) -- mark
+  end
+
+  local thingType = g_things.getThingType(id, ThingCategoryItem)
+  if thingType:isStackable() or thingType:isFluidContainer() or thingType:isSplash() or thingType:isChargeable() then
+    msg:addU8(1)
+  end
+
+  if g_game.getFeature(GameItemAnimationPhase) and thingType:getAnimationPhases() > 1 then
+    msg:addU8(0) -- automatic phase
+  end
+end
+
+local function addOutfit(msg, creature)
+  if g_game.getFeature(GameLooktypeU16) then
+    msg:addU16(creature.lookType)
+  else
+    msg:addU8(creature.lookType)
+  end
+  for _, color in ipairs(creature.colors) do
+    msg:addU8(color)
+  end
+  if g_game.getFeature(GamePlayerAddons) then
+    msg:addU8(0)
+  end
+
+  if g_game.getFeature(GamePlayerMounts) then
+    msg:addU16(0)
+  end
+end
+
+local function addCreature(msg, creature, removeId)
+  msg:addU16(UnknownCreature)
+  msg:addU32(removeId or 0)
+  msg:addU32(creature.id)
+  if g_game.getClientVersion() >= 910 then
+    msg:addU8(creature.type)
+  end
+  msg:addString(creature.name)
+
+  msg:addU8(100) -- health percent
+  msg:addU8(creature.direction)
+  addOutfit(msg, creature)
+  msg:addU8(0) -- light intensity
+  msg:addU8(0) -- light color
+  msg:addU16(creature.speed)
+  msg:addU8(0) -- skull
+  msg:addU8(0) -- shield
+
+  if g_game.getFeature(GameCreatureEmblems) then
+    msg:addU8(0)
+  end
+
+  if g_game.getFeature(GameThingMarks) then
+    msg:addU8(creature.type)
+  end
+
+  if g_game.getFeature(GameCreatureIcons) then
+    msg:addU8(0)
+  end
+
+  if g_game.getFeature(GameThingMarks) then
+    msg:addU8(0xFF) -- mark
+    msg:addU16(0) -- helpers
+  end
+
+  if g_game.getClientVersion() >= 854 then
+    msg:addU8(1) -- unpassable
+  end
+end
+
+local function addTile(msg, x, y)
+  addItem(msg, world.groundId)
+
+  local tile = getTileCreatures(x, y)
+  if tile then
+    for _, creature in ipairs(tile) do
+      addCreature(msg, creature)
+    end
+  end
+end
+
+-- same layout the client reads in ProtocolGame::setMapDescription, only the player floor has tiles
+local function addMapArea(msg, x, y, z, width, height)
+  local startz, endz, zstep
+  if z > SeaFloor then
+    startz = z - AwareUndergroundFloorRange
+    endz = math.min(z + AwareUndergroundFloorRange, MaxZ)
+    zstep = 1
+  else
+    startz = SeaFloor
+    endz = 0
+    zstep = -1
+  end
+
+  local skip = -1
+  for nz = startz, endz, zstep do
+    local offset = z - nz
+    for nx = 0, width - 1 do
+      for ny = 0, height - 1 do
+        if nz == z then
+          if skip >= 0 then
+            msg:addU16(0xFF00 + skip)
+          end
+          skip = 0
+          addTile(msg, x + nx + offset, y + ny + offset)
+        elseif skip == 0xFE then
+          msg:addU16(0xFFFF)
+          skip = -1
+        else
+          skip = skip + 1
+        end
+      end
+    end
+  end
+
+  if skip >= 0 then
+    msg:addU16(0xFF00 + skip)
+  end
+end
+
+local function horizontal()
+  return world.range.left + world.range.right + 1
+end
+
+local function vertical()
+  return world.range.top + world.range.bottom + 1
+end
+
+local function addCreatureMove(msg, creature, x, y)
+  placeCreature(creature, x, y)
+  msg:addU8(GameServerOpcodes.GameServerMoveCreature)
+  msg:addU16(0xFFFF)
+  msg:addU32(creature.id)
+  addPosition(msg, x, y, world.center.z)
+end
+
+local function addCreatureRespawn(msg, creature)
+  local x, y = randomFreePosition()
+  placeCreature(creature, x, y)
+  msg:addU8(GameServerOpcodes.GameServerCreateOnMap)
+  addPosition(msg, x, y, world.center.z)
+  if g_game.getClientVersion() >= 841 then
+    msg:addU8(0xFF) -- stack position chosen by the client
+  end
+  addCreature(msg, creature, creature.id)
+end
+
+function createWorld(options, playerName)
+  world = {
+    options = options,
+    center = { x = options.position.x, y = options.position.y, z = options.position.z },
+    range = { left = 8, right = 9, top = 6, bottom = 7 },
+    groundId = findGround(options.groundId),
+    tiles = {},
+    creatures = {},
+    effectBudget = 0
+  }
+
+  world.player = {
+    id = PlayerId,
+    type = CreatureTypePlayer,
+    name = playerName ~= '' and playerName or options.characterName,
+    lookType = options.playerOutfit,
+    colors = { 78, 69, 58, 76 },
+    speed = options.playerSpeed,
+    direction = Directions.South
+  }
+  placeCreature(world.player, world.center.x, world.center.y)
+
+  local now = g_clock.millis()
+  for i = 1, options.creatures do
+    local creature = {
+      id = CreatureStartId + i - 1,
+      type = CreatureTypeMonster,
+      name = 'Creature ' .. i,
+      lookType = options.creatureOutfits[math.random(1, #options.creatureOutfits)],
+      colors = { math.random(0, 132), math.random(0, 132), math.random(0, 132), math.random(0, 132) },
+      speed = options.creatureSpeed,
+      direction = math.random(Directions.North, Directions.West),
+      nextWalk = now + math.random(0, options.walkInterval)
+    }
+    placeCreature(creature, randomFreePosition())
+    table.insert(world.creatures, creature)
+  end
+end
+
+function destroyWorld()
+  world = nil
+end
+
+function getPlayerName()
+  return world.player.name
+end
+
+function setAwareRange(xrange, yrange)
+  -- same split the client does when the server confirms the range
+  world.range.left = math.floor(xrange / 2) - (xrange + 1) % 2
+  world.range.right = math.floor(xrange / 2)
+  world.range.top = math.floor(yrange / 2) - (yrange + 1) % 2
+  world.range.bottom = math.floor(yrange / 2)
+end
+
+function addLogin(msg)
+  local loginOpcode = LoginOrPendingState
+  if g_game.getFeature(GameLoginPending) then
+    loginOpcode = LoginSuccess
+  end
+
+  msg:addU8(loginOpcode)
+  msg:addU32(world.player.id)
+  msg:addU16(50) -- server beat
+
+  if g_game.getFeature(GameNewSpeedLaw) then
+    addDouble(msg, 857.36, 3)
+    addDouble(msg, 261.29, 3)
+    addDouble(msg, -4795.01, 3)
+  end
+
+  msg:addU8(0) -- can report bugs
+
+  if g_game.getClientVersion() >= 1054 then
+    msg:addU8(0) -- can change pvp frame option
+  end
+
+  if g_game.getClientVersion() >= 1058 then
+    msg:addU8(0) -- expert mode
+  end
+
+  if g_game.getFeature(GameIngameStore) then
+    msg:addString('')
+    msg:addU16(25)
+  end
+
+  if g_game.getFeature(GameLoginPending) then
+    msg:addU8(LoginOrPendingState)
+    msg:addU8(GameServerOpcodes.GameServerEnterGame)
+  end
+end
+
+function addWorldLight(msg)
+  msg:addU8(GameServerOpcodes.GameServerAmbient)
+  msg:addU8(250)
+  msg:addU8(215)
+end
+
+function addMapDescription(msg)
+  local center, range = world.center, world.range
+  msg:addU8(GameServerOpcodes.GameServerFullMap)
+  addPosition(msg, center.x, center.y, center.z)
+  addMapArea(msg, center.x - range.left, center.y - range.top, center.z, horizontal(), vertical())
+end
+
+function addPlayerWalk(msg, direction)
+  local offset = DirectionOffsets[direction]
+  if not offset then
+    return
+  end
+
+  local center, range = world.center, world.range
+  local player = world.player
+  addCreatureMove(msg, player, center.x + offset.x, center.y + offset.y)
+
+  -- the rows that came into view, the client moves its central position after each
+  local function addRow(opcode, dx, dy)
+    msg:addU8(opcode)
+    if g_game.getFeature(GameMapMovePosition) then
+      addPosition(msg, center.x, center.y, center.z)
+    end
+    center.x = center.x + dx
+    center.y = center.y + dy
+
+    if dy < 0 then
+      addMapArea(msg, center.x - range.left, center.y - range.top, center.z, horizontal(), 1)
+    elseif dy > 0 then
+      addMapArea(msg, center.x - range.left, center.y + range.bottom, center.z, horizontal(), 1)
+    elseif dx > 0 then
+      addMapArea(msg, center.x + range.right, center.y - range.top, center.z, 1, vertical())
+    else
+      addMapArea(msg, center.x - range.left, center.y - range.top, center.z, 1, vertical())
+    end
+  end
+
+  if offset.y < 0 then
+    addRow(GameServerOpcodes.GameServerMapTopRow, 0, -1)
+  elseif offset.y > 0 then
+    addRow(GameServerOpcodes.GameServerMapBottomRow, 0, 1)
+  end
+  if offset.x > 0 then
+    addRow(GameServerOpcodes.GameServerMapRightRow, 1, 0)
+  elseif offset.x < 0 then
+    addRow(GameServerOpcodes.GameServerMapLeftRow, -1, 0)
+  end
+
+  -- creatures left behind were dropped by the client, they reappear next to the player
+  for _, creature in ipairs(world.creatures) do
+    if not isAware(creature.pos.x, creature.pos.y) then
+      addCreatureRespawn(msg, creature)
+    end
+  end
+end
+
+function addPlayerTurn(msg, direction)
+  local player = world.player
+  player.direction = direction
+
+  msg:addU8(GameServerOpcodes.GameServerChangeOnMap)
+  msg:addU16(0xFFFF)
+  msg:addU32(player.id)
+  msg:addU16(KnownCreature)
+  msg:addU32(player.id)
+  msg:addU8(direction)
+  if g_game.getClientVersion() >= 953 then
+    msg:addU8(1) -- unpassable
+  end
+end
+
+function addWorldTick(msg, elapsed)
+  local options = world.options
+  local now = g_clock.millis()
+  local written = false
+
+  for _, creature in ipairs(world.creatures) do
+    if creature.nextWalk <= now then
+      creature.nextWalk = now + options.walkInterval
+
+      -- step back towards the player when outside the box, otherwise wander
+      local x, y = creature.pos.x, creature.pos.y
+      local dx, dy = 0, 0
+      if not isInsideBox(x, y) then
+        if x < world.center.x then dx = 1 elseif x > world.center.x then dx = -1 end
+        if y < world.center.y then dy = 1 elseif y > world.center.y then dy = -1 end
+      else
+        local offset = DirectionOffsets[math.random(Directions.North, Directions.West)]
+        dx, dy = offset.x, offset.y
+      end
+
+      if (dx ~= 0 or dy ~= 0) and isAware(x + dx, y + dy) and canStand(x + dx, y + dy) then
+        addCreatureMove(msg, creature, x + dx, y + dy)
+        written = true
+      end
+    end
+  end
+
+  if options.effectsPerSecond > 0 and #options.effects > 0 then
+    world.effectBudget = world.effectBudget + options.effectsPerSecond * elapsed / 1000
+    while world.effectBudget >= 1 do
+      world.effectBudget = world.effectBudget - 1
+
+      local x, y = randomFreePosition()
+      msg:addU8(GameServerOpcodes.GameServerGraphicalEffect)
+      addPosition(msg, x, y, world.center.z)
+      local effectId = options.effects[math.random(1, #options.effects)]
+      if g_game.getFeature(GameMagicEffectU16) then
+        msg:addU16(effectId)
+      else
+        msg:addU8(effectId)
+      end
+      written = true
+    end
+  end
+
+  return written
+end
@@ -23,6 +23,7 @@
 #include "animatedtext.h"
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/graphics/drawqueue.h>
 #include <framework/graphics/graphics.h>
 #include "game.h"
 #include "map.h"
@@ -57,9 +58,9 @@ void AnimatedText::drawText(const Point& dest, const Rect& visibleRect)
         if(t > t0) {
             Color color = m_color;
             color.setAlpha(static_cast<float>(1 - (t - t0) / (tf - t0)));
-            g_painter->setColor(color);
+            g_drawQueue.setColor(color);
         } else
-            g_painter->setColor(m_color);
+            g_drawQueue.setColor(m_color);
         m_cachedText.draw(rect);
     }
 }
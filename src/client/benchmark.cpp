@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "benchmark.h"
+#include "game.h"
+#include "opcodeprofiler.h"
+#include <framework/core/application.h>
+#include <framework/core/eventdispatcher.h>
+#include <framework/platform/platform.h>
+#include <framework/platform/platformwindow.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+Benchmark g_benchmark;
+
+#ifdef BENCHMARK
+static std::atomic<uint64> allocationCount(0);
+
+// replacing the global allocator costs every allocation an atomic increment,
+// so it is only compiled into builds made for benchmarking
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if(void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+template<typename T>
+static T percentile(const std::vector<T>& sorted, double p)
+{
+    if(sorted.empty())
+        return 0;
+    size_t index = std::min<size_t>(sorted.size() - 1, (size_t)(p * (sorted.size() - 1) + 0.5));
+    return sorted[index];
+}
+
+Benchmark::Benchmark()
+{
+    m_speed = 1.0f;
+    m_startMicros = 0;
+    m_lastFrameMicros = 0;
+    m_lastAllocations = 0;
+}
+
+uint64 Benchmark::getAllocationCount()
+{
+#ifdef BENCHMARK
+    return allocationCount.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+void Benchmark::start()
+{
+    if(m_running || !isEnabled())
+        return;
+
+    // frames must not be throttled while measuring
+    g_app.setForegroundPaneMaxFps(0);
+    g_app.setBackgroundPaneMaxFps(0);
+    g_window.setVerticalSync(false);
+
+    try {
+        g_game.playRecord(m_recordFile, m_speed);
+    } catch(stdext::exception& e) {
+        g_logger.error(stdext::format("unable to start benchmark: %s", e.what()));
+        g_app.exit();
+        return;
+    }
+
+    m_running = true;
+    m_frameTimes.clear();
+    m_frameAllocations.clear();
+    m_mapDrawTimes.clear();
+    g_opcodeProfiler.reset();
+    g_opcodeProfiler.setEnabled(true);
+    m_startMicros = stdext::micros();
+    m_lastFrameMicros = m_startMicros;
+    m_lastAllocations = getAllocationCount();
+    m_pollEvent = g_dispatcher.scheduleEvent(std::bind(&Benchmark::poll, this), 0);
+}
+
+void Benchmark::poll()
+{
+    m_pollEvent = nullptr;
+
+    // the dispatcher is polled once per frame, the interval between polls is the frame time
+    const ticks_t now = stdext::micros();
+    const uint64 allocations = getAllocationCount();
+    m_frameTimes.push_back(now - m_lastFrameMicros);
+    m_frameAllocations.push_back(allocations - m_lastAllocations);
+    m_lastFrameMicros = now;
+    m_lastAllocations = allocations;
+
+    if(!g_game.isPlayingRecord()) {
+        finish();
+        return;
+    }
+
+    m_pollEvent = g_dispatcher.scheduleEvent(std::bind(&Benchmark::poll, this), 0);
+}
+
+void Benchmark::finish()
+{
+    m_running = false;
+    g_opcodeProfiler.setEnabled(false);
+
+    const std::string report = getReport();
+    if(m_outputFile.empty())
+        stdext::print(report);
+    else {
+        std::ofstream out(m_outputFile);
+        if(!out)
+            g_logger.error(stdext::format("unable to write benchmark report to '%s'", m_outputFile));
+        out << report << std::endl;
+    }
+
+    g_app.exit();
+}
+
+std::string Benchmark::getReport()
+{
+    std::vector<ticks_t> frameTimes = m_frameTimes;
+    std::vector<ticks_t> mapDrawTimes = m_mapDrawTimes;
+    std::sort(frameTimes.begin(), frameTimes.end());
+    std::sort(mapDrawTimes.begin(), mapDrawTimes.end());
+
+    uint64 totalAllocations = 0;
+    for(uint64 allocations : m_frameAllocations)
+        totalAllocations += allocations;
+
+    ticks_t totalMapDraw = 0;
+    for(ticks_t micros : mapDrawTimes)
+        totalMapDraw += micros;
+
+    std::string recordFile = m_recordFile;
+    stdext::replace_all(recordFile, "\\", "\\\\");
+    stdext::replace_all(recordFile, "\"", "\\\"");
+
+    // times are in microseconds and memory in bytes
+    std::stringstream ss;
+    ss << "{\n";
+    ss << "  \"record\": \"" << recordFile << "\",\n";
+    ss << "  \"speed\": " << m_speed << ",\n";
+    ss << "  \"duration\": " << (stdext::micros() - m_startMicros) << ",\n";
+    ss << "  \"frames\": " << frameTimes.size() << ",\n";
+    ss << "  \"frame_time\": { \"p50\": " << percentile(frameTimes, 0.50)
+       << ", \"p95\": " << percentile(frameTimes, 0.95)
+       << ", \"p99\": " << percentile(frameTimes, 0.99)
+       << ", \"max\": " << (frameTimes.empty() ? 0 : frameTimes.back()) << " },\n";
+    ss << "  \"map_draw\": { \"count\": " << mapDrawTimes.size()
+       << ", \"total\": " << totalMapDraw
+       << ", \"p50\": " << percentile(mapDrawTimes, 0.50)
+       << ", \"p95\": " << percentile(mapDrawTimes, 0.95)
+       << ", \"p99\": " << percentile(mapDrawTimes, 0.99) << " },\n";
+#ifdef BENCHMARK
+    ss << "  \"allocations\": { \"total\": " << totalAllocations
+       << ", \"per_frame\": " << (m_frameAllocations.empty() ? 0 : totalAllocations / m_frameAllocations.size()) << " },\n";
+#else
+    ss << "  \"allocations\": null,\n";
+#endif
+    ss << "  \"peak_rss\": " << (uint64)g_platform.getPeakMemoryUsage() << ",\n";
+    ss << "  \"opcodes\": [";
+    bool first = true;
+    for(int opcode : g_opcodeProfiler.getProfiledOpcodes()) {
+        const OpcodeProfiler::OpcodeStats& stats = g_opcodeProfiler.getStats(opcode);
+        ss << (first ? "\n" : ",\n");
+        ss << "    { \"opcode\": " << opcode
+           << ", \"count\": " << stats.count
+           << ", \"bytes\": " << stats.bytes
+           << ", \"total\": " << stats.totalMicros
+           << ", \"max\": " << stats.maxMicros
+           << ", \"lua\": " << stats.luaMicros << " }";
+        first = false;
+    }
+    ss << "\n  ]\n";
+    ss << "}";
+    return ss.str();
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "declarations.h"
+#include <framework/core/declarations.h>
+
+// @bindsingleton g_benchmark
+class Benchmark
+{
+public:
+    Benchmark();
+
+    void setRecordFile(const std::string& fileName) { m_recordFile = fileName; }
+    void setOutputFile(const std::string& fileName) { m_outputFile = fileName; }
+    void setSpeed(float speed) { m_speed = speed; }
+
+    bool isEnabled() { return !m_recordFile.empty(); }
+    bool isRunning() { return m_running; }
+
+    void start();
+
+    void addMapDraw(ticks_t micros) { m_mapDrawTimes.push_back(micros); }
+
+    static uint64 getAllocationCount();
+
+private:
+    void poll();
+    void finish();
+    std::string getReport();
+
+    std::string m_recordFile;
+    std::string m_outputFile;
+    float m_speed;
+    stdext::boolean<false> m_running;
+    ticks_t m_startMicros;
+    ticks_t m_lastFrameMicros;
+    uint64 m_lastAllocations;
+    std::vector<ticks_t> m_frameTimes;
+    std::vector<uint64> m_frameAllocations;
+    std::vector<ticks_t> m_mapDrawTimes;
+    ScheduledEventPtr m_pollEvent;
+};
+
+extern Benchmark g_benchmark;
+
+#endif
@@ -22,9 +22,12 @@
 
 #include "client.h"
 #include <framework/core/configmanager.h>
+#include <framework/core/eventdispatcher.h>
 #include <framework/core/modulemanager.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/graphics/graphics.h>
+#include <framework/net/connection.h>
+#include "benchmark.h"
 #include "game.h"
 #include "map.h"
 #include "minimap.h"
@@ -33,7 +36,7 @@
 
 Client g_client;
 
-void Client::init(std::vector<std::string>& /*args*/)
+void Client::init(std::vector<std::string>& args)
 {
     // register needed lua functions
     registerLuaFunctions();
@@ -44,6 +47,27 @@ void Client::init(std::vector<std::string>& /*args*/)
     g_shaders.init();
     g_things.init();
 
+    for(uint i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        if((arg == "-benchmark" || arg == "--benchmark") && hasValue)
+            g_benchmark.setRecordFile(args[++i]);
+        else if((arg == "-benchmark-output" || arg == "--benchmark-output") && hasValue)
+            g_benchmark.setOutputFile(args[++i]);
+        else if((arg == "-benchmark-speed" || arg == "--benchmark-speed") && hasValue)
+            g_benchmark.setSpeed(stdext::unsafe_cast<float>(args[++i], 1.0f));
+        else if(arg == "-network-thread" || arg == "--network-thread")
+            Connection::startNetworkThread();
+    }
+
+    // benchmarks draw with the null painter and start once all modules are loaded,
+    // a window and GL context are still created
+    if(g_benchmark.isEnabled()) {
+        g_graphics.parseOption("-null-painter");
+        g_graphics.selectPainterEngine(Graphics::Painter_Null);
+        g_dispatcher.addEvent(std::bind(&Benchmark::start, &g_benchmark));
+    }
+
     //TODO: restore options
 /*
     if(g_graphics.parseOption(arg))
@@ -437,6 +437,7 @@ namespace Otc
         GameIngameStoreHighlights = 74,
         GameIngameStoreServiceType = 75,
         GameAdditionalSkills = 76,
+        GamePacketCompression = 77,
 
         LastGameFeature = 101
     };
@@ -33,6 +33,7 @@
 
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/graphics/drawqueue.h>
 #include <framework/graphics/graphics.h>
 
 #include <framework/graphics/framebuffermanager.h>
@@ -74,23 +75,23 @@ void Creature::draw(const Point& dest, float scaleFactor, bool animate, const Hi
 
     if(frameFlags & Otc::FUpdateThing) {
         if(m_showTimedSquare) {
-            g_painter->setColor(m_timedSquareColor);
-            g_painter->drawBoundingRect(Rect(dest + (m_walkOffset - getDisplacement() + 2) * scaleFactor, Size(28, 28) * scaleFactor), std::max<int>(static_cast<int>(2 * scaleFactor), 1));
-            g_painter->resetColor();
+            g_drawQueue.setColor(m_timedSquareColor);
+            g_drawQueue.drawBoundingRect(Rect(dest + (m_walkOffset - getDisplacement() + 2) * scaleFactor, Size(28, 28) * scaleFactor), std::max<int>(static_cast<int>(2 * scaleFactor), 1));
+            g_drawQueue.resetColor();
         }
 
         if(m_showStaticSquare) {
-            g_painter->setColor(m_staticSquareColor);
-            g_painter->drawBoundingRect(Rect(dest + (m_walkOffset - getDisplacement()) * scaleFactor, Size(Otc::TILE_PIXELS, Otc::TILE_PIXELS) * scaleFactor), std::max<int>(static_cast<int>(2 * scaleFactor), 1));
-            g_painter->resetColor();
+            g_drawQueue.setColor(m_staticSquareColor);
+            g_drawQueue.drawBoundingRect(Rect(dest + (m_walkOffset - getDisplacement()) * scaleFactor, Size(Otc::TILE_PIXELS, Otc::TILE_PIXELS) * scaleFactor), std::max<int>(static_cast<int>(2 * scaleFactor), 1));
+            g_drawQueue.resetColor();
         }
 
         internalDrawOutfit(dest + m_walkOffset * scaleFactor, scaleFactor, animate, false, m_direction);
 
         if(highLight.enabled && this == highLight.thing) {
-            g_painter->setColor(highLight.rgbColor);
+            g_drawQueue.setColor(highLight.rgbColor);
             internalDrawOutfit(dest + m_walkOffset * scaleFactor, scaleFactor, animate, true, m_direction);
-            g_painter->resetColor();
+            g_drawQueue.resetColor();
         }
     }
 
@@ -113,7 +114,7 @@ void Creature::draw(const Point& dest, float scaleFactor, bool animate, const Hi
 void Creature::internalDrawOutfit(Point dest, float scaleFactor, bool animateWalk, bool useBlank, Otc::Direction direction)
 {
     if(m_outfitColor != Color::white)
-        g_painter->setColor(m_outfitColor);
+        g_drawQueue.setColor(m_outfitColor);
 
     // outfit is a real creature
     if(m_outfit.getCategory() == ThingCategoryCreature) {
@@ -157,19 +158,19 @@ void Creature::internalDrawOutfit(Point dest, float scaleFactor, bool animateWal
             datType->draw(m_position, dest, scaleFactor, 0, xPattern, yPattern, zPattern, animationPhase, useBlank);
 
             if(!useBlank && getLayers() > 1) {
-                Color oldColor = g_painter->getColor();
-                const Painter::CompositionMode oldComposition = g_painter->getCompositionMode();
-                g_painter->setCompositionMode(Painter::CompositionMode_Multiply);
-                g_painter->setColor(m_outfit.getHeadColor());
+                Color oldColor = g_drawQueue.getColor();
+                const Painter::CompositionMode oldComposition = g_drawQueue.getCompositionMode();
+                g_drawQueue.setCompositionMode(Painter::CompositionMode_Multiply);
+                g_drawQueue.setColor(m_outfit.getHeadColor());
                 datType->draw(m_position, dest, scaleFactor, SpriteMaskYellow, xPattern, yPattern, zPattern, animationPhase, false);
-                g_painter->setColor(m_outfit.getBodyColor());
+                g_drawQueue.setColor(m_outfit.getBodyColor());
                 datType->draw(m_position, dest, scaleFactor, SpriteMaskRed, xPattern, yPattern, zPattern, animationPhase, false);
-                g_painter->setColor(m_outfit.getLegsColor());
+                g_drawQueue.setColor(m_outfit.getLegsColor());
                 datType->draw(m_position, dest, scaleFactor, SpriteMaskGreen, xPattern, yPattern, zPattern, animationPhase, false);
-                g_painter->setColor(m_outfit.getFeetColor());
+                g_drawQueue.setColor(m_outfit.getFeetColor());
                 datType->draw(m_position, dest, scaleFactor, SpriteMaskBlue, xPattern, yPattern, zPattern, animationPhase, false);
-                g_painter->setColor(oldColor);
-                g_painter->setCompositionMode(oldComposition);
+                g_drawQueue.setColor(oldColor);
+                g_drawQueue.setCompositionMode(oldComposition);
             }
         }
         // outfit is a creature imitating an item or the invisible effect
@@ -198,7 +199,7 @@ void Creature::internalDrawOutfit(Point dest, float scaleFactor, bool animateWal
     }
 
     if(m_outfitColor != Color::white)
-        g_painter->resetColor();
+        g_drawQueue.resetColor();
 }
 
 void Creature::drawOutfit(const Rect& destRect, bool resize)
@@ -225,6 +226,13 @@ void Creature::drawOutfit(const Rect& destRect, bool resize)
     }
 }
 
+enum : uint8 {
+    InformationBackgroundLayer,
+    InformationBarLayer,
+    InformationTextLayer,
+    InformationIconLayer
+};
+
 void Creature::drawInformation(const Rect& parentRect, int drawFlags)
 {
     if(m_healthPercent < 1) // creature is dead
@@ -265,20 +273,25 @@ void Creature::drawInformation(const Rect& parentRect, int drawFlags)
     if(g_game.getFeature(Otc::GameBlueNpcNameColor) && isNpc() && m_healthPercent == 100 && !useGray)
         fillColor = Color(0x66, 0xcc, 0xff);
 
+    // when the map view records the information of all creatures at once, the layers
+    // keep every bar background below the bars, and the names and icons above them
     if(drawFlags & Otc::DrawBars && (!isNpc() || !g_game.getFeature(Otc::GameHideNpcNames))) {
-        g_painter->setColor(Color::black);
-        g_painter->drawFilledRect(backgroundRect);
+        g_drawQueue.setLayer(InformationBackgroundLayer);
+        g_drawQueue.setColor(Color::black);
+        g_drawQueue.drawFilledRect(backgroundRect);
 
-        g_painter->setColor(fillColor);
-        g_painter->drawFilledRect(healthRect);
+        g_drawQueue.setLayer(InformationBarLayer);
+        g_drawQueue.setColor(fillColor);
+        g_drawQueue.drawFilledRect(healthRect);
 
         if(drawFlags & Otc::DrawManaBar && isLocalPlayer()) {
             LocalPlayerPtr player = g_game.getLocalPlayer();
             if(player) {
                 backgroundRect.moveTop(backgroundRect.bottom());
 
-                g_painter->setColor(Color::black);
-                g_painter->drawFilledRect(backgroundRect);
+                g_drawQueue.setLayer(InformationBackgroundLayer);
+                g_drawQueue.setColor(Color::black);
+                g_drawQueue.drawFilledRect(backgroundRect);
 
                 Rect manaRect = backgroundRect.expanded(-1);
                 const double maxMana = player->getMaxMana();
@@ -288,43 +301,42 @@ void Creature::drawInformation(const Rect& parentRect, int drawFlags)
                     manaRect.setWidth(player->getMana() / (maxMana * 1.0) * 25);
                 }
 
-                g_painter->setColor(Color::blue);
-                g_painter->drawFilledRect(manaRect);
+                g_drawQueue.setLayer(InformationBarLayer);
+                g_drawQueue.setColor(Color::blue);
+                g_drawQueue.drawFilledRect(manaRect);
             }
         }
     }
 
+    g_drawQueue.setLayer(InformationTextLayer);
     if(drawFlags & Otc::DrawNames) {
-        if(g_painter->getColor() != fillColor)
-            g_painter->setColor(fillColor);
+        g_drawQueue.setColor(fillColor);
         m_nameCache.draw(textRect);
     }
 
+    g_drawQueue.setLayer(InformationIconLayer);
+    g_drawQueue.resetColor();
     if(m_skull != Otc::SkullNone && m_skullTexture) {
-        g_painter->resetColor();
         const Rect skullRect = Rect(backgroundRect.x() + 13.5 + 12, backgroundRect.y() + 5, m_skullTexture->getSize());
-        g_painter->drawTexturedRect(skullRect, m_skullTexture);
+        g_drawQueue.drawTexturedRect(skullRect, m_skullTexture);
     }
     if(m_shield != Otc::ShieldNone && m_shieldTexture && m_showShieldTexture) {
-        g_painter->resetColor();
         const Rect shieldRect = Rect(backgroundRect.x() + 13.5, backgroundRect.y() + 5, m_shieldTexture->getSize());
-        g_painter->drawTexturedRect(shieldRect, m_shieldTexture);
+        g_drawQueue.drawTexturedRect(shieldRect, m_shieldTexture);
     }
     if(m_emblem != Otc::EmblemNone && m_emblemTexture) {
-        g_painter->resetColor();
         const Rect emblemRect = Rect(backgroundRect.x() + 13.5 + 12, backgroundRect.y() + 16, m_emblemTexture->getSize());
-        g_painter->drawTexturedRect(emblemRect, m_emblemTexture);
+        g_drawQueue.drawTexturedRect(emblemRect, m_emblemTexture);
     }
     if(m_type != Proto::CreatureTypeUnknown && m_typeTexture) {
-        g_painter->resetColor();
         const Rect typeRect = Rect(backgroundRect.x() + 13.5 + 12 + 12, backgroundRect.y() + 16, m_typeTexture->getSize());
-        g_painter->drawTexturedRect(typeRect, m_typeTexture);
+        g_drawQueue.drawTexturedRect(typeRect, m_typeTexture);
     }
     if(m_icon != Otc::NpcIconNone && m_iconTexture) {
-        g_painter->resetColor();
         const Rect iconRect = Rect(backgroundRect.x() + 13.5 + 12, backgroundRect.y() + 5, m_iconTexture->getSize());
-        g_painter->drawTexturedRect(iconRect, m_iconTexture);
+        g_drawQueue.drawTexturedRect(iconRect, m_iconTexture);
     }
+    g_drawQueue.resetLayer();
 }
 
 void Creature::turn(Otc::Direction direction)
@@ -1030,6 +1042,18 @@ int Creature::getCurrentAnimationPhase(const bool mount)
     return m_walkAnimationPhase;
 }
 
+// whether the outfit changes over time even while the creature stands still
+bool Creature::isOutfitAnimated()
+{
+    if(m_outfit.getCategory() != ThingCategoryCreature)
+        return g_things.rawGetThingType(m_outfit.getAuxId(), m_outfit.getCategory())->getAnimationPhases() > 1;
+
+    const auto isAnimated = [](ThingType* type) {
+        return type->getIdleAnimator() != nullptr || (type->isAnimateAlways() && type->getAnimationPhases() > 1);
+    };
+    return isAnimated(rawGetThingType()) || (m_outfit.hasMount() && isAnimated(rawGetMountThingType()));
+}
+
 int Creature::getAnimationInterval()
 {
     const auto& datType = m_outfit.hasMount() ? rawGetMountThingType() : rawGetThingType();
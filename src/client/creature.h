@@ -112,6 +112,7 @@ public:
 
     int getTotalAnimationPhase();
     int getCurrentAnimationPhase(bool mount = false);
+    bool isOutfitAnimated();
 
     void updateShield();
 
@@ -23,6 +23,8 @@
 #include "game.h"
 #include <framework/core/application.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/net/packetplayer.h>
+#include <framework/net/packetrecorder.h>
 #include <framework/ui/uimanager.h>
 #include "container.h"
 #include "creature.h"
@@ -272,9 +274,11 @@ void Game::processPingBack()
 {
     ++m_pingReceived;
 
-    if(m_pingReceived == m_pingSent)
+    if(m_pingReceived == m_pingSent) {
         m_ping = m_pingTimer.elapsed_millis();
-    else
+        if(m_protocolGame && m_protocolGame->getConnection())
+            m_protocolGame->getConnection()->addRttSample(m_ping);
+    } else
         g_logger.error("got an invalid ping from server");
 
     g_lua.callGlobalField("g_game", "onPingBack", m_ping);
@@ -545,11 +549,45 @@ void Game::loginWorld(const std::string& account, const std::string& password, c
     m_localPlayer->setName(characterName);
 
     m_protocolGame = ProtocolGamePtr(new ProtocolGame);
+
+    if(!m_packetRecordFile.empty()) {
+        try {
+            PacketRecorderPtr recorder(new PacketRecorder(m_packetRecordFile));
+            recorder->writeHeader(m_protocolVersion, m_clientVersion, characterName, worldName);
+            m_protocolGame->setRecorder(recorder);
+        } catch(stdext::exception& e) {
+            g_logger.error(stdext::format("unable to record packets: %s", e.what()));
+        }
+    }
+
     m_protocolGame->login(account, password, worldHost, static_cast<uint16>(worldPort), characterName, authenticatorToken, sessionKey);
     m_characterName = characterName;
     m_worldName = worldName;
 }
 
+void Game::playRecord(const std::string& fileName, float speed)
+{
+    if(m_protocolGame || isOnline())
+        stdext::throw_exception("Unable to play a record while already online or logging.");
+
+    PacketPlayerPtr player(new PacketPlayer(fileName));
+    player->setSpeed(speed);
+
+    setClientVersion(player->getClientVersion());
+    setProtocolVersion(player->getProtocolVersion());
+
+    // reset the new game state
+    resetGameStates();
+
+    m_localPlayer = LocalPlayerPtr(new LocalPlayer);
+    m_localPlayer->setName(player->getCharacterName());
+
+    m_protocolGame = ProtocolGamePtr(new ProtocolGame);
+    m_protocolGame->playRecord(player);
+    m_characterName = player->getCharacterName();
+    m_worldName = player->getWorldName();
+}
+
 void Game::cancelLogin()
 {
     // send logout even if the game has not started yet, to make sure that the player doesn't stay logged there
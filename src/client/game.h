@@ -164,6 +164,10 @@ public:
     // login related
     void loginWorld(const std::string& account, const std::string& password, const std::string& worldName, const std::string& worldHost, int worldPort, const std::string& characterName, const std::string& authenticatorToken, const std::string& sessionKey);
     void cancelLogin();
+    void playRecord(const std::string& fileName, float speed);
+    bool isPlayingRecord() { return m_protocolGame && m_protocolGame->isPlayingRecord(); }
+    void setPacketRecordFile(const std::string& fileName) { m_packetRecordFile = fileName; }
+    std::string getPacketRecordFile() { return m_packetRecordFile; }
     void forceLogout();
     void safeLogout();
 
@@ -391,6 +395,7 @@ private:
     std::vector<uint8> m_gmActions;
     std::string m_characterName;
     std::string m_worldName;
+    std::string m_packetRecordFile;
     std::bitset<Otc::LastGameFeature> m_features;
     ScheduledEventPtr m_pingEvent;
     ScheduledEventPtr m_walkEvent;
@@ -35,6 +35,7 @@
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/filestream.h>
+#include <framework/graphics/drawqueue.h>
 #include <framework/graphics/graphics.h>
 
 Item::Item() :
@@ -80,7 +81,7 @@ void Item::draw(const Point& dest, float scaleFactor, bool animate, const Highli
     calculatePatterns(xPattern, yPattern, zPattern);
 
     if(m_color != Color::alpha)
-        g_painter->setColor(m_color);
+        g_drawQueue.setColor(m_color);
 
     rawGetThingType()->draw(m_position, dest, scaleFactor, 0, xPattern, yPattern, zPattern, animationPhase, false, frameFlag, lightView);
 
@@ -88,12 +89,12 @@ void Item::draw(const Point& dest, float scaleFactor, bool animate, const Highli
     /// This is just to ensure that we don't overwrite some color and
     /// screw up the whole rendering.
     if(m_color != Color::alpha)
-        g_painter->resetColor();
+        g_drawQueue.resetColor();
 
     if(highLight.enabled && this == highLight.thing) {
-        g_painter->setColor(highLight.rgbColor);
+        g_drawQueue.setColor(highLight.rgbColor);
         rawGetThingType()->draw(m_position, dest, scaleFactor, 0, xPattern, yPattern, zPattern, animationPhase, true, frameFlag, lightView);
-        g_painter->resetColor();
+        g_drawQueue.resetColor();
     }
 }
 
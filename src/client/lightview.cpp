@@ -21,16 +21,23 @@
  */
 
 #include "lightview.h"
+#include <framework/graphics/drawqueue.h>
 #include <framework/graphics/framebuffer.h>
 #include <framework/graphics/framebuffermanager.h>
 #include <framework/graphics/image.h>
+#include <framework/graphics/texture.h>
 #include <framework/graphics/painter.h>
 #include "mapview.h"
 #include "map.h"
+#include "shadermanager.h"
+#include <framework/graphics/graphics.h>
 
 enum {
     MAX_LIGHT_INTENSITY = 8,
-    MAX_AMBIENT_LIGHT_INTENSITY = _UI8_MAX
+    MAX_AMBIENT_LIGHT_INTENSITY = _UI8_MAX,
+    MAX_DIMENSION_INTENSITY = 32,
+    OCCLUSION_UNKNOWN = -2,
+    OCCLUSION_BLOCKED = -1
 };
 
 #define DEBUG_BUBBLE 0
@@ -44,6 +51,9 @@ LightView::LightView(const MapViewPtr& mapView, const uint8 version)
     m_lightTexture = generateLightBubble();
     m_blendEquation = Painter::BlendEquation_Add;
 
+    // builds the light shapes up front, away from the drawing hot path
+    getDimensionConfig(0);
+
     reset();
 }
 
@@ -169,9 +179,8 @@ void LightView::addLightSourceV2(const Position& pos, const Point& center, float
         extraOffset.second = (creature->getWalkOffset() + Point(16, 16)) * scaleFactor;
     }
 
-    const auto& dimension = getDimensionConfig(intensity);
-    for each(const auto & position in dimension.positions)
-    {
+    const DimensionConfig& dimension = getDimensionConfig(std::min<int>(intensity, MAX_DIMENSION_INTENSITY));
+    for(const DimensionPosition& position : dimension) {
         const auto posLight = posTile.translated(position.x, position.y);
         auto& lightSource = getLightSource(posLight);
 
@@ -188,14 +197,14 @@ void LightView::addLightSourceV2(const Position& pos, const Point& center, float
 
         lightSource.color = color;
         lightSource.radius = radius;
-        lightSource.center = center + ((position.point * Otc::TILE_PIXELS) * scaleFactor);
+        lightSource.center = center + ((Point(position.x, position.y) * Otc::TILE_PIXELS) * scaleFactor);
         lightSource.intensity = intensity;
         lightSource.brightness = brightness;
         lightSource.extraOffset = extraOffset;
     }
 
     if(checkAround) {
-        for each(const auto & position in dimension.positions) {
+        for(const DimensionPosition& position : dimension) {
             auto posLight = posTile.translated(position.x, position.y);
             auto& lightSource = getLightSource(posLight);
             if(!lightSource.isValid()) continue;
@@ -217,71 +226,115 @@ void LightView::addLightSourceV2(const Position& pos, const Point& center, float
     }
 }
 
-const DimensionConfig LightView::getDimensionConfig(const uint8 intensity)
+namespace {
+
+// light shapes of every intensity, packed in a single array and built once
+struct LightDimensions
 {
+    std::vector<DimensionPosition> positions;
+    std::vector<uint64> edgeMask;
+    std::array<DimensionConfig, MAX_DIMENSION_INTENSITY + 1> configs;
+
+    LightDimensions()
+    {
+        for(int intensity = 0; intensity <= MAX_DIMENSION_INTENSITY; ++intensity) {
+            DimensionConfig& config = configs[intensity];
+            config.first = positions.size();
+            build(intensity);
+            config.count = positions.size() - config.first;
+        }
+
+        edgeMask.resize((positions.size() + 63) / 64);
+        for(DimensionConfig& config : configs) {
+            config.positions = positions.data() + config.first;
+            config.edgeMask = edgeMask.data();
+            findEdges(config);
+        }
+    }
+
+    void build(const int intensity)
+    {
 #if DEBUG_BUBBLE == 1
-    const float startBrightness = 3;
+        const float startBrightness = 3;
 #else
-    const float startBrightness = intensity == 1 ? .15 : .35;
+        const float startBrightness = intensity == 1 ? .15 : .35;
 #endif
 
-    auto& dimension = m_dimensionCache[intensity];
-    if(dimension.positions.empty()) {
         const int size = std::max<int>(1, std::floor(static_cast<float>(intensity) / 1.1)),
-            start = size * -1,
-            middle = (size / 2);
-
-        // TODO: REFATORATION REQUIRED
-        // Ugly algorithm
-        {
-            auto pushLight = [&](const int8 x, const int8 y) -> void {
-                const float brightness = startBrightness - ((std::max<float>(std::abs(x), std::abs(y)) * 1.5) / 50);
-
-                PositionLight posLight = PositionLight(x, y, brightness);
-                posLight.point = Point(x, y);
-
-                dimension.positions.push_back(posLight);
-            };
-
-            int i = 1;
-            for(int_fast8_t x = start; x < 0; ++x) {
-                for(int_fast8_t y = i * -1; y <= i; ++y) {
-                    if(x == start || y == start || y == size) continue;
-                    pushLight(x, y);
-                }
-                ++i;
+            start = size * -1;
+
+        auto pushLight = [&](const int x, const int y) {
+            const float brightness = startBrightness - ((std::max<float>(std::abs(x), std::abs(y)) * 1.5) / 50);
+            positions.push_back({ static_cast<int8>(x), static_cast<int8>(y), brightness });
+        };
+
+        int i = 1;
+        for(int x = start; x < 0; ++x) {
+            for(int y = i * -1; y <= i; ++y) {
+                if(x == start || y == start || y == size) continue;
+                pushLight(x, y);
             }
+            ++i;
+        }
 
-            i = 1;
-            for(int_fast8_t x = size; x >= 0; --x) {
-                for(int_fast8_t y = i * -1; y <= i; ++y) {
-                    if(y >= size || y <= start || x == size) continue;
-                    pushLight(x, y);
-                }
-                ++i;
+        i = 1;
+        for(int x = size; x >= 0; --x) {
+            for(int y = i * -1; y <= i; ++y) {
+                if(y >= size || y <= start || x == size) continue;
+                pushLight(x, y);
             }
+            ++i;
         }
+    }
 
-        for each(auto & pos in dimension.positions)
-        {
-            for each(auto & posAround in pos.getPositionsAround())
-            {
-                if(std::find(dimension.positions.begin(), dimension.positions.end(), posAround) == dimension.positions.end()) {
-                    dimension.edges.push_back(pos);
-                    break;
+    // a position is an edge when any of its 8 neighbours is outside the shape
+    void findEdges(const DimensionConfig& config)
+    {
+        int extent = 0;
+        for(const DimensionPosition& position : config)
+            extent = std::max<int>(extent, std::max<int>(std::abs(position.x), std::abs(position.y)));
+
+        const int side = extent * 2 + 3;
+        std::vector<uint8> inside(side * side, 0);
+        auto cell = [&](const int x, const int y) { return (y + extent + 1) * side + (x + extent + 1); };
+
+        for(const DimensionPosition& position : config)
+            inside[cell(position.x, position.y)] = 1;
+
+        for(uint32 i = 0; i < config.count; ++i) {
+            const DimensionPosition& position = config.positions[i];
+            bool edge = false;
+            for(int y = -1; y <= 1 && !edge; ++y) {
+                for(int x = -1; x <= 1; ++x) {
+                    if(!inside[cell(position.x + x, position.y + y)]) {
+                        edge = true;
+                        break;
+                    }
                 }
             }
+
+            if(edge) {
+                const uint32 bit = config.first + i;
+                edgeMask[bit / 64] |= uint64(1) << (bit % 64);
+            }
         }
     }
+};
 
-    return dimension;
+}
+
+const DimensionConfig& LightView::getDimensionConfig(const uint8 intensity)
+{
+    static const LightDimensions dimensions;
+    return dimensions.configs[std::min<int>(intensity, MAX_DIMENSION_INTENSITY)];
 }
 
 static LightSource INVALID_LIGHT_SOURCE(-1);
 LightSource& LightView::getLightSource(const Position& pos)
 {
     const auto& point = m_mapView->transformPositionTo2D(pos, m_mapView->getCameraPosition());
-    size_t index = (m_mapView->m_drawDimension.width() * (point.y / Otc::TILE_PIXELS)) + (point.x / Otc::TILE_PIXELS);
+    const int tileSize = m_mapView->m_tileSize;
+    size_t index = (m_mapView->m_drawDimension.width() * (point.y / tileSize)) + (point.x / tileSize);
 
     if(index >= m_lightMap.size()) return INVALID_LIGHT_SOURCE;
 
@@ -289,25 +342,81 @@ LightSource& LightView::getLightSource(const Position& pos)
 }
 
 bool LightView::canDraw(const Position& pos, float& brightness)
+{
+    int8 occlusion;
+    const size_t index = getOcclusionIndex(pos);
+    if(index < m_occlusionGrid.size()) {
+        int8& cached = m_occlusionGrid[index];
+        if(cached == OCCLUSION_UNKNOWN)
+            cached = calcOcclusion(pos);
+        occlusion = cached;
+    } else
+        occlusion = calcOcclusion(pos);
+
+    if(occlusion == OCCLUSION_BLOCKED)
+        return false;
+
+    brightness -= occlusion * 0.05;
+    return true;
+}
+
+// returns OCCLUSION_BLOCKED or how many tiles above dim the light
+int8 LightView::calcOcclusion(const Position& pos)
 {
     TilePtr tile = g_map.getTile(pos);
     if(!tile || tile->isCovered() || tile->isTopGround() && !tile->hasBottomToDraw() || !tile->hasGround()) {
-        return false;
+        return OCCLUSION_BLOCKED;
     }
 
+    int8 occlusion = 0;
     Position tilePos = pos;
     while(tilePos.coveredUp() && tilePos.z >= m_mapView->getCachedFirstVisibleFloor()) {
         tile = g_map.getTile(tilePos);
         if(tile) {
             if(tile->blockLight() || tile->isTopGround()) {
-                return false;
+                return OCCLUSION_BLOCKED;
             }
 
-            brightness -= 0.05;
+            ++occlusion;
         }
     }
 
-    return true;
+    return occlusion;
+}
+
+// positions covering each other share the same column, so a column holds every floor
+size_t LightView::getOcclusionIndex(const Position& pos)
+{
+    // the camera can move before the visible tiles cache catches up
+    const Position cameraPosition = m_mapView->getCameraPosition();
+    if(cameraPosition != m_occlusionCameraPosition) {
+        resetOcclusion();
+        m_occlusionCameraPosition = cameraPosition;
+    }
+
+    const auto& point = m_mapView->transformPositionTo2D(pos, cameraPosition);
+    const int tileSize = m_mapView->m_tileSize,
+        width = m_mapView->m_drawDimension.width();
+
+    if(point.x < 0 || point.y < 0 || point.x / tileSize >= width || point.y / tileSize >= m_mapView->m_drawDimension.height())
+        return std::numeric_limits<size_t>::max();
+
+    return ((point.y / tileSize) * width + (point.x / tileSize)) * (Otc::MAX_Z + 1) + pos.z;
+}
+
+void LightView::resetOcclusion()
+{
+    std::fill(m_occlusionGrid.begin(), m_occlusionGrid.end(), OCCLUSION_UNKNOWN);
+}
+
+void LightView::invalidateOcclusion(const Position& pos)
+{
+    const size_t index = getOcclusionIndex(pos);
+    if(index >= m_occlusionGrid.size())
+        return;
+
+    const size_t columnStart = index - pos.z;
+    std::fill(m_occlusionGrid.begin() + columnStart, m_occlusionGrid.begin() + columnStart + Otc::MAX_Z + 1, OCCLUSION_UNKNOWN);
 }
 
 void LightView::drawGlobalLight(const Light& light)
@@ -318,8 +427,8 @@ void LightView::drawGlobalLight(const Light& light)
     color.setGreen(color.gF() * brightness);
     color.setBlue(color.bF() * brightness);
 
-    g_painter->setColor(color);
-    g_painter->drawFilledRect(Rect(0, 0, m_lightbuffer->getSize()));
+    g_drawQueue.setColor(color);
+    g_drawQueue.drawFilledRect(Rect(0, 0, m_lightbuffer->getSize()));
 }
 
 void LightView::drawLightSource(const LightSource& light)
@@ -327,9 +436,78 @@ void LightView::drawLightSource(const LightSource& light)
     // debug draw
     //radius /= 16;
 
-    const Rect dest = Rect(light.center - Point(light.radius, light.radius), Size(light.radius * 2, light.radius * 2));
-    g_painter->setColor(light.color);
-    g_painter->drawTexturedRect(dest, m_lightTexture);
+    g_drawQueue.setColor(light.color);
+    g_drawQueue.addLightSource(light.center, light.radius, m_lightTexture);
+}
+
+bool LightView::canUseLightMapShader()
+{
+    return m_version == 2 && g_painter->hasShaders() && g_graphics.shouldUseShaders() && g_shaders.getLightMapShader();
+}
+
+void LightView::drawLightMap()
+{
+    const Size& dimension = m_mapView->m_drawDimension;
+    const int width = dimension.width(),
+        tileSize = m_mapView->m_tileSize;
+
+    // color and radius on the left half, light center offsets on the right half
+    const Size imageSize(width * 2, dimension.height());
+    if(!m_lightMapImage || m_lightMapImage->getSize() != imageSize)
+        m_lightMapImage = ImagePtr(new Image(imageSize));
+
+    for(size_t i = 0; i < m_lightMap.size(); ++i) {
+        LightSource& source = m_lightMap[i];
+        const int x = i % width,
+            y = i / width;
+
+        if(!source.hasLight()) {
+            uint8 pixel[4] = { 0, 0, 0, 0 };
+            m_lightMapImage->setPixel(x, y, pixel);
+            continue;
+        }
+
+        // the shader only looks 4 tiles around each pixel, so the light center offset
+        // plus the radius must stay inside that, moved lights get a smaller radius
+        const Point center = source.center + (source.canMove ? source.extraOffset.second : source.extraOffset.first);
+        const float offsetX = stdext::clamp<float>((center.x - x * tileSize) / static_cast<float>(tileSize), -2.f, 2.f),
+            offsetY = stdext::clamp<float>((center.y - y * tileSize) / static_cast<float>(tileSize), -2.f, 2.f),
+            maxRadius = 4.f - std::max<float>(std::abs(offsetX), std::abs(offsetY)),
+            radius = stdext::clamp<float>(source.radius / static_cast<float>(tileSize), .1f, maxRadius);
+
+        uint8 pixel[4] = { source.color.r(), source.color.g(), source.color.b(), static_cast<uint8>(radius / 4.f * 0xff) };
+        m_lightMapImage->setPixel(x, y, pixel);
+
+        uint8 offset[4] = { static_cast<uint8>((offsetX / 4.f + .5f) * 0xff), static_cast<uint8>((offsetY / 4.f + .5f) * 0xff), 0, 0xff };
+        m_lightMapImage->setPixel(x + width, y, offset);
+
+        source.reset();
+    }
+
+    if(!m_lightMapTexture)
+        m_lightMapTexture = TexturePtr(new Texture(m_lightMapImage));
+    else
+        m_lightMapTexture->uploadPixels(m_lightMapImage);
+
+    Color globalColor = Color::from8bit(m_globalLight.color);
+    const float brightness = m_globalLight.intensity / static_cast<float>(MAX_AMBIENT_LIGHT_INTENSITY);
+    globalColor.setRed(globalColor.rF() * brightness);
+    globalColor.setGreen(globalColor.gF() * brightness);
+    globalColor.setBlue(globalColor.bF() * brightness);
+
+    const Size& texSize = m_lightMapTexture->getGlSize();
+    const PainterShaderProgramPtr& shader = g_shaders.getLightMapShader();
+    shader->bind();
+    shader->setUniformValue(ShaderManager::LIGHT_MAP_SIZE, static_cast<float>(width), static_cast<float>(dimension.height()));
+    shader->setUniformValue(ShaderManager::LIGHT_TEXTURE_SIZE, static_cast<float>(texSize.width()), static_cast<float>(texSize.height()));
+    shader->setUniformValue(ShaderManager::LIGHT_BLEND_MAX, m_blendEquation == Painter::BlendEquation_Max ? 1.f : 0.f);
+
+    // one pass replaces the whole buffer, the shader adds the global light itself
+    g_painter->setShaderProgram(shader);
+    g_painter->setColor(globalColor);
+    g_painter->setCompositionMode(Painter::CompositionMode_Replace);
+    g_painter->drawTexturedRect(Rect(0, 0, m_lightbuffer->getSize()), m_lightMapTexture, Rect(0, 0, width, dimension.height()));
+    g_painter->resetShaderProgram();
 }
 
 void LightView::resize()
@@ -338,6 +516,7 @@ void LightView::resize()
 
     if(m_version == 2) {
         m_lightMap.resize(m_mapView->m_drawDimension.area());
+        m_occlusionGrid.assign(m_mapView->m_drawDimension.area() * (Otc::MAX_Z + 1), OCCLUSION_UNKNOWN);
     }
 }
 
@@ -347,14 +526,23 @@ void LightView::draw(const Rect& dest, const Rect& src)
     if(!isDark() || m_lightbuffer->getTexture() == nullptr) return;
 
     g_painter->saveAndResetState();
-    if(m_lightbuffer->canUpdate()) {
+    if(m_lightbuffer->canUpdate() && canUseLightMapShader()) {
         m_lightbuffer->bind();
-        g_painter->setCompositionMode(Painter::CompositionMode_Replace);
+        drawLightMap();
+        m_lightbuffer->release();
+    } else if(m_lightbuffer->canUpdate()) {
+        m_lightbuffer->bind();
+        g_drawQueue.startRecording();
+        g_drawQueue.setCompositionMode(Painter::CompositionMode_Replace);
 
         drawGlobalLight(m_globalLight);
 
-        g_painter->setBlendEquation(m_blendEquation);
-        g_painter->setCompositionMode(Painter::CompositionMode_Add);
+        g_drawQueue.setBlendEquation(m_blendEquation);
+        g_drawQueue.setCompositionMode(Painter::CompositionMode_Add);
+
+        // additive light bubbles don't depend on drawing order,
+        // so the queue is free to group them by color
+        g_drawQueue.lockDepth();
 
         if(m_version == 1) {
             for(const LightSource& source : m_lightMap)
@@ -372,6 +560,8 @@ void LightView::draw(const Rect& dest, const Rect& src)
             }
         }
 
+        g_drawQueue.stopRecording();
+        g_drawQueue.flush();
         m_lightbuffer->release();
     }
     g_painter->setCompositionMode(Painter::CompositionMode_Light);
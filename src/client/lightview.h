@@ -29,19 +29,26 @@
 #include "declarations.h"
 #include "thingtype.h"
 
-struct PositionLight : Position {
-    PositionLight(int8 x, int8 y, float brightness) : brightness(brightness) { Position::x = x, Position::y = y, z = _UI8_MAX; }
+struct DimensionPosition {
+    int8 x;
+    int8 y;
     float brightness;
-    Point point;
 };
 
+// read-only view over the precomputed shape of one light intensity
 struct DimensionConfig {
-    std::vector<PositionLight> positions;
-    std::vector<PositionLight> edges;
+    const DimensionPosition* positions = nullptr;
+    const uint64* edgeMask = nullptr;
+    uint32 first = 0;
+    uint32 count = 0;
 
-    bool isEdge(const Position pos) const
+    const DimensionPosition* begin() const { return positions; }
+    const DimensionPosition* end() const { return positions + count; }
+
+    bool isEdge(uint32 index) const
     {
-        return std::find(edges.begin(), edges.end(), pos) != edges.end();
+        const uint32 bit = first + index;
+        return (edgeMask[bit / 64] >> (bit % 64)) & 1;
     }
 };
 
@@ -74,6 +81,9 @@ public:
     void draw(const Rect& dest, const Rect& src);
 
     void setBlendEquation(Painter::BlendEquation blendEquation) { m_blendEquation = blendEquation; }
+    void resetOcclusion();
+    void invalidateOcclusion(const Position& pos);
+
     void schedulePainting(const uint16_t delay = FrameBuffer::MIN_TIME_UPDATE) { if(isDark()) m_lightbuffer->schedulePainting(delay); }
     bool canUpdate() const { return isDark() && m_lightbuffer->canUpdate(); }
 
@@ -87,21 +97,33 @@ private:
     void addLightSourceV2(const Position& pos, const Point& center, float scaleFactor, const Light& light, const ThingPtr& thing);
     void drawGlobalLight(const Light& light);
     void drawLightSource(const LightSource& light);
+    void drawLightMap();
+    bool canUseLightMapShader();
     bool canDraw(const Position& pos, float& brightness);
+    int8 calcOcclusion(const Position& pos);
+    size_t getOcclusionIndex(const Position& pos);
 
-    const DimensionConfig getDimensionConfig(const uint8 intensity);
+    static const DimensionConfig& getDimensionConfig(const uint8 intensity);
 
     Light m_globalLight;
 
     TexturePtr generateLightBubble();
     TexturePtr m_lightTexture;
 
+    // per tile light map consumed by the light map shader
+    ImagePtr m_lightMapImage;
+    TexturePtr m_lightMapTexture;
+
     Painter::BlendEquation m_blendEquation;
 
     FrameBufferPtr m_lightbuffer;
 
     std::vector<LightSource> m_lightMap;
-    std::array<DimensionConfig, _UI8_MAX> m_dimensionCache;
+
+    // light occlusion of every floor of each visible column, filled on demand
+    // and cleared whenever the visible tiles cache is rebuilt
+    std::vector<int8> m_occlusionGrid;
+    Position m_occlusionCameraPosition;
     MapViewPtr m_mapView;
 
     LightSource& getLightSource(const Position& pos);
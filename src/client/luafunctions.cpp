@@ -21,6 +21,7 @@
  */
 
 #include "animatedtext.h"
+#include "benchmark.h"
 #include "client.h"
 #include "container.h"
 #include "creature.h"
@@ -33,6 +34,7 @@
 #include "map.h"
 #include "minimap.h"
 #include "missile.h"
+#include "opcodeprofiler.h"
 #include "outfit.h"
 #include "player.h"
 #include "protocolgame.h"
@@ -115,8 +117,9 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_map", "clean", &Map::clean, &g_map);
     g_lua.bindSingletonFunction("g_map", "cleanTile", &Map::cleanTile, &g_map);
     g_lua.bindSingletonFunction("g_map", "cleanTexts", &Map::cleanTexts, &g_map);
-    g_lua.bindSingletonFunction("g_map", "getTile", &Map::getTile, &g_map);
+    g_lua.bindSingletonFunction("g_map", "getTile", &Map::materializeTile, &g_map);
     g_lua.bindSingletonFunction("g_map", "getTiles", &Map::getTiles, &g_map);
+    g_lua.bindSingletonFunction("g_map", "getPendingTileCount", &Map::getPendingTileCount, &g_map);
     g_lua.bindSingletonFunction("g_map", "setCentralPosition", &Map::setCentralPosition, &g_map);
     g_lua.bindSingletonFunction("g_map", "getCentralPosition", &Map::getCentralPosition, &g_map);
     g_lua.bindSingletonFunction("g_map", "getCreatureById", &Map::getCreatureById, &g_map);
@@ -185,6 +188,10 @@ void Client::registerLuaFunctions()
     g_lua.registerSingletonClass("g_game");
     g_lua.bindSingletonFunction("g_game", "loginWorld", &Game::loginWorld, &g_game);
     g_lua.bindSingletonFunction("g_game", "cancelLogin", &Game::cancelLogin, &g_game);
+    g_lua.bindSingletonFunction("g_game", "playRecord", &Game::playRecord, &g_game);
+    g_lua.bindSingletonFunction("g_game", "isPlayingRecord", &Game::isPlayingRecord, &g_game);
+    g_lua.bindSingletonFunction("g_game", "setPacketRecordFile", &Game::setPacketRecordFile, &g_game);
+    g_lua.bindSingletonFunction("g_game", "getPacketRecordFile", &Game::getPacketRecordFile, &g_game);
     g_lua.bindSingletonFunction("g_game", "forceLogout", &Game::forceLogout, &g_game);
     g_lua.bindSingletonFunction("g_game", "safeLogout", &Game::safeLogout, &g_game);
     g_lua.bindSingletonFunction("g_game", "walk", &Game::walk, &g_game);
@@ -309,6 +316,19 @@ void Client::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_game", "transferCoins", &Game::transferCoins, &g_game);
     g_lua.bindSingletonFunction("g_game", "openTransactionHistory", &Game::openTransactionHistory, &g_game);
 
+    g_lua.registerSingletonClass("g_benchmark");
+    g_lua.bindSingletonFunction("g_benchmark", "isEnabled", &Benchmark::isEnabled, &g_benchmark);
+    g_lua.bindSingletonFunction("g_benchmark", "isRunning", &Benchmark::isRunning, &g_benchmark);
+
+    g_lua.registerSingletonClass("g_opcodeProfiler");
+    g_lua.bindSingletonFunction("g_opcodeProfiler", "setEnabled", &OpcodeProfiler::setEnabled, &g_opcodeProfiler);
+    g_lua.bindSingletonFunction("g_opcodeProfiler", "isEnabled", &OpcodeProfiler::isEnabled, &g_opcodeProfiler);
+    g_lua.bindSingletonFunction("g_opcodeProfiler", "reset", &OpcodeProfiler::reset, &g_opcodeProfiler);
+    g_lua.bindSingletonFunction("g_opcodeProfiler", "getOpcodeStats", &OpcodeProfiler::getOpcodeStats, &g_opcodeProfiler);
+    g_lua.bindSingletonFunction("g_opcodeProfiler", "getProfiledOpcodes", &OpcodeProfiler::getProfiledOpcodes, &g_opcodeProfiler);
+    g_lua.bindSingletonFunction("g_opcodeProfiler", "getReport", &OpcodeProfiler::getReport, &g_opcodeProfiler);
+    g_lua.bindSingletonFunction("g_opcodeProfiler", "dump", &OpcodeProfiler::dump, &g_opcodeProfiler);
+
     g_lua.registerSingletonClass("g_shaders");
     g_lua.bindSingletonFunction("g_shaders", "createShader", &ShaderManager::createShader, &g_shaders);
     g_lua.bindSingletonFunction("g_shaders", "createFragmentShader", &ShaderManager::createFragmentShader, &g_shaders);
@@ -325,12 +345,15 @@ void Client::registerLuaFunctions()
 
     g_lua.registerClass<ProtocolGame, Protocol>();
     g_lua.bindClassStaticFunction<ProtocolGame>("create", [] { return ProtocolGamePtr(new ProtocolGame); });
+    g_lua.bindClassStaticFunction<ProtocolGame>("hookOpcode", &ProtocolGame::hookOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("unhookOpcode", &ProtocolGame::unhookOpcode);
+    g_lua.bindClassStaticFunction<ProtocolGame>("isOpcodeHooked", &ProtocolGame::isOpcodeHooked);
     g_lua.bindClassMemberFunction<ProtocolGame>("login", &ProtocolGame::login);
     g_lua.bindClassMemberFunction<ProtocolGame>("sendExtendedOpcode", &ProtocolGame::sendExtendedOpcode);
     g_lua.bindClassMemberFunction<ProtocolGame>("addPosition", &ProtocolGame::addPosition);
     g_lua.bindClassMemberFunction<ProtocolGame>("setMapDescription", &ProtocolGame::setMapDescription);
     g_lua.bindClassMemberFunction<ProtocolGame>("setFloorDescription", &ProtocolGame::setFloorDescription);
-    g_lua.bindClassMemberFunction<ProtocolGame>("setTileDescription", &ProtocolGame::setTileDescription);
+    g_lua.bindClassMemberFunction<ProtocolGame>("setTileDescription", static_cast<int (ProtocolGame::*)(const InputMessagePtr&, Position)>(&ProtocolGame::setTileDescription));
     g_lua.bindClassMemberFunction<ProtocolGame>("getOutfit", &ProtocolGame::getOutfit);
     g_lua.bindClassMemberFunction<ProtocolGame>("getThing", &ProtocolGame::getThing);
     g_lua.bindClassMemberFunction<ProtocolGame>("getCreature", &ProtocolGame::getCreature);
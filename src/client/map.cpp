@@ -28,6 +28,7 @@
 #include "minimap.h"
 #include "missile.h"
 #include "statictext.h"
+#include "thingtypemanager.h"
 #include "tile.h"
 
 #include <framework/core/application.h>
@@ -106,6 +107,7 @@ void Map::clean()
     for(int_fast8_t i = -1; ++i <= Otc::MAX_Z;)
         m_tileBlocks[i].clear();
 
+    m_pendingTiles.clear();
     m_waypoints.clear();
 
     g_towns.clear();
@@ -201,7 +203,8 @@ void Map::addThing(const ThingPtr& thing, const Position& pos, int16 stackPos)
 
 ThingPtr Map::getThing(const Position& pos, int16 stackPos)
 {
-    if(TilePtr tile = getTile(pos))
+    // the server refers to things by stack position, deferred tiles must exist to be updated
+    if(TilePtr tile = materializeTile(pos))
         return tile->getThing(stackPos);
 
     return nullptr;
@@ -256,7 +259,7 @@ bool Map::removeThing(const ThingPtr& thing)
 
 bool Map::removeThingByPos(const Position& pos, int16 stackPos)
 {
-    if(TilePtr tile = getTile(pos))
+    if(TilePtr tile = materializeTile(pos))
         return removeThing(tile->getThing(stackPos));
 
     return false;
@@ -327,6 +330,8 @@ const TilePtr& Map::createTile(const Position& pos)
         m_tilesRect.setBottom(pos.y);
 
     TileBlock& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
+    if(block.isPending(pos))
+        removePendingTile(block, pos);
     return block.create(pos);
 }
 
@@ -362,6 +367,8 @@ const TilePtr& Map::getOrCreateTile(const Position& pos)
         m_tilesRect.setBottom(pos.y);
 
     TileBlock& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
+    if(block.isPending(pos))
+        return materializeBlockTile(block, pos);
     return block.getOrCreate(pos);
 }
 
@@ -382,6 +389,8 @@ const TileList Map::getTiles(int8 floor/* = -1*/)
     TileList tiles;
     if(floor > Otc::MAX_Z) return tiles;
 
+    materializePendingTiles();
+
     if(floor < 0) {
         // Search all floors
         for(int_fast8_t z = -1; ++z <= Otc::MAX_Z;) {
@@ -414,7 +423,10 @@ void Map::cleanTile(const Position& pos)
     auto it = m_tileBlocks[pos.z].find(getBlockIndex(pos));
     if(it != m_tileBlocks[pos.z].end()) {
         TileBlock& block = it->second;
-        if(const TilePtr& tile = block.get(pos)) {
+        if(block.isPending(pos)) {
+            removePendingTile(block, pos);
+            notificateTileUpdate(pos, nullptr, Otc::OPERATION_CLEAN);
+        } else if(const TilePtr& tile = block.get(pos)) {
             tile->clean();
             if(tile->canErase())
                 block.remove(pos);
@@ -432,6 +444,127 @@ void Map::cleanTile(const Position& pos)
     }
 }
 
+void Map::setPendingTile(const Position& pos, PendingTile&& items)
+{
+    if(!pos.isMapPosition() || items.empty())
+        return;
+
+    if(pos.x < m_tilesRect.left())
+        m_tilesRect.setLeft(pos.x);
+
+    if(pos.y < m_tilesRect.top())
+        m_tilesRect.setTop(pos.y);
+
+    if(pos.x > m_tilesRect.right())
+        m_tilesRect.setRight(pos.x);
+
+    if(pos.y > m_tilesRect.bottom())
+        m_tilesRect.setBottom(pos.y);
+
+    TileBlock& block = m_tileBlocks[pos.z][getBlockIndex(pos)];
+    if(block.get(pos)) {
+        // the tile is still alive (walking creatures, effects), fill it right away
+        m_pendingTiles[pos] = std::move(items);
+        materializeBlockTile(block, pos);
+        return;
+    }
+    block.setPending(pos, true);
+
+    // the minimap must not wait for the tile to be created, derive what it needs from the item types
+    MinimapTileBuilder builder;
+    for(const PendingTileItem& item : items)
+        builder.addItem(g_things.rawGetThingType(item.id, ThingCategoryItem));
+
+    m_pendingTiles[pos] = std::move(items);
+    g_minimap.updateTile(pos, builder.build());
+}
+
+bool Map::isDrawingFloor(uint8 z)
+{
+    // the views' cached floors still belong to the camera before this update,
+    // so the range is worked out from the new central position
+    for(const MapViewPtr& mapView : m_mapViews) {
+        const Position cameraPosition = mapView->isFollowingCreature() ? m_centralPosition : mapView->getCameraPosition();
+
+        uint8 firstFloor, lastFloor;
+        mapView->getDrawableFloorRange(cameraPosition, firstFloor, lastFloor);
+        if(z < firstFloor || z > lastFloor)
+            continue;
+
+        // surface floors are described from the bottom up, so the floors between the camera
+        // and this one are known already and may hide it, e.g. a roof over the player
+        if(cameraPosition.isValid() && z + 1 < cameraPosition.z && mapView->isMultifloor() &&
+           mapView->getLockedFirstVisibleFloor() == _UI8_MAX && mapView->calcFirstUncoveredFloor(cameraPosition, z + 1) > z + 1)
+            continue;
+
+        return true;
+    }
+    return false;
+}
+
+const TilePtr& Map::materializeTile(const Position& pos)
+{
+    if(!pos.isMapPosition())
+        return m_nulltile;
+
+    auto it = m_tileBlocks[pos.z].find(getBlockIndex(pos));
+    if(it == m_tileBlocks[pos.z].end())
+        return m_nulltile;
+
+    TileBlock& block = it->second;
+    if(!block.isPending(pos))
+        return block.get(pos);
+    return materializeBlockTile(block, pos);
+}
+
+void Map::materializeFloors(uint8 firstFloor, uint8 lastFloor)
+{
+    if(m_pendingTiles.empty())
+        return;
+
+    std::vector<Position> positions;
+    for(const auto& pair : m_pendingTiles) {
+        if(pair.first.z >= firstFloor && pair.first.z <= lastFloor)
+            positions.push_back(pair.first);
+    }
+
+    for(const Position& pos : positions)
+        materializeBlockTile(m_tileBlocks[pos.z][getBlockIndex(pos)], pos);
+}
+
+const TilePtr& Map::materializeBlockTile(TileBlock& block, const Position& pos)
+{
+    auto it = m_pendingTiles.find(pos);
+    block.setPending(pos, false);
+    if(it == m_pendingTiles.end())
+        return block.get(pos);
+
+    const PendingTile items = std::move(it->second);
+    m_pendingTiles.erase(it);
+
+    const TilePtr& tile = block.getOrCreate(pos);
+    for(const PendingTileItem& pending : items) {
+        const ItemPtr item = Item::create(pending.id);
+        item->setCountOrSubType(pending.countOrSubType);
+        addThing(item, pos, pending.stackPos);
+    }
+    return tile;
+}
+
+void Map::materializePendingTiles()
+{
+    while(!m_pendingTiles.empty()) {
+        const Position pos = m_pendingTiles.begin()->first;
+        materializeBlockTile(m_tileBlocks[pos.z][getBlockIndex(pos)], pos);
+    }
+}
+
+void Map::removePendingTile(TileBlock& block, const Position& pos)
+{
+    block.setPending(pos, false);
+    m_pendingTiles.erase(pos);
+}
+
 void Map::setShowZone(tileflags_t zone, bool show)
 {
     if(show)
@@ -507,6 +640,8 @@ std::map<Position, ItemPtr> Map::findItemsById(uint16 clientId, uint32 max)
 {
     std::map<Position, ItemPtr> ret;
     uint32 count = 0;
+
+    materializePendingTiles();
     for(uint8_t z = 0; z <= Otc::MAX_Z; ++z) {
         for(const auto& pair : m_tileBlocks[z]) {
             const TileBlock& block = pair.second;
@@ -569,12 +704,26 @@ void Map::removeUnawareThings()
     }
 
     if(!g_game.getFeature(Otc::GameKeepUnawareTiles)) {
+        // pending tiles out of range are dropped without ever being created
+        for(auto it = m_pendingTiles.begin(); it != m_pendingTiles.end();) {
+            const Position& pos = it->first;
+            if(isAwareOfPosition(pos)) {
+                ++it;
+                continue;
+            }
+
+            auto blockIt = m_tileBlocks[pos.z].find(getBlockIndex(pos));
+            if(blockIt != m_tileBlocks[pos.z].end())
+                blockIt->second.setPending(pos, false);
+            it = m_pendingTiles.erase(it);
+        }
+
         // remove tiles that we are not aware anymore
         for(int_fast8_t z = -1; ++z <= Otc::MAX_Z;) {
             std::unordered_map<uint, TileBlock>& tileBlocks = m_tileBlocks[z];
             for(auto it = tileBlocks.begin(); it != tileBlocks.end();) {
                 TileBlock& block = (*it).second;
-                bool blockEmpty = true;
+                bool blockEmpty = !block.hasPending();
                 for(const TilePtr& tile : block.getTiles()) {
                     if(!tile) continue;
 
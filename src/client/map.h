@@ -34,6 +34,8 @@
 #include <framework/core/clock.h>
 #include <framework/graphics/framebuffer.h>
 
+#include <bitset>
+
 enum OTBM_ItemAttr
 {
     OTBM_ATTR_DESCRIPTION = 1,
@@ -94,6 +96,15 @@ enum {
     BLOCK_SIZE = 32
 };
 
+// an item of a tile description that was decoded but not turned into a Thing yet
+struct PendingTileItem {
+    uint16 id;
+    uint8 countOrSubType;
+    uint8 stackPos;
+};
+
+typedef std::vector<PendingTileItem> PendingTile;
+
 enum : uint8 {
     Animation_Force,
     Animation_Show
@@ -119,12 +130,17 @@ public:
     const TilePtr& get(const Position& pos) { return m_tiles[getTileIndex(pos)]; }
     void remove(const Position& pos) { m_tiles[getTileIndex(pos)] = nullptr; }
 
+    void setPending(const Position& pos, bool pending) { m_pending.set(getTileIndex(pos), pending); }
+    bool isPending(const Position& pos) { return m_pending.test(getTileIndex(pos)); }
+    bool hasPending() const { return m_pending.any(); }
+
     uint getTileIndex(const Position& pos) { return ((pos.y % BLOCK_SIZE) * BLOCK_SIZE) + (pos.x % BLOCK_SIZE); }
 
     const std::array<TilePtr, BLOCK_SIZE* BLOCK_SIZE>& getTiles() const { return m_tiles; }
 
 private:
     std::array<TilePtr, BLOCK_SIZE* BLOCK_SIZE> m_tiles;
+    std::bitset<BLOCK_SIZE* BLOCK_SIZE> m_pending;
 };
 
 //@bindsingleton g_map
@@ -185,6 +201,15 @@ public:
     const TileList getTiles(int8 floor = -1);
     void cleanTile(const Position& pos);
 
+    // tiles decoded from the server whose things are only created once they are
+    // needed; getTile does not see them, getThing, removeThingByPos and lua getTile
+    // materialize them
+    void setPendingTile(const Position& pos, PendingTile&& items);
+    const TilePtr& materializeTile(const Position& pos);
+    void materializeFloors(uint8 firstFloor, uint8 lastFloor);
+    bool isDrawingFloor(uint8 z);
+    size_t getPendingTileCount() { return m_pendingTiles.size(); }
+
     // tile zone related
     void setShowZone(tileflags_t zone, bool show);
     void setShowZones(bool show);
@@ -247,6 +272,9 @@ public:
 
 private:
     void removeUnawareThings();
+    const TilePtr& materializeBlockTile(TileBlock& block, const Position& pos);
+    void materializePendingTiles();
+    void removePendingTile(TileBlock& block, const Position& pos);
 
     uint16 getBlockIndex(const Position& pos) { return ((pos.y / BLOCK_SIZE) * (65536 / BLOCK_SIZE)) + (pos.x / BLOCK_SIZE); }
 
@@ -257,6 +285,7 @@ private:
     std::vector<MapViewPtr> m_mapViews;
 
     std::unordered_map<uint, TileBlock> m_tileBlocks[Otc::MAX_Z + 1];
+    std::unordered_map<Position, PendingTile, PositionHasher> m_pendingTiles;
     std::unordered_map<uint32, CreaturePtr> m_knownCreatures;
     std::unordered_map<Position, std::string, PositionHasher> m_waypoints;
 
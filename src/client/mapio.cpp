@@ -234,6 +234,8 @@ void Map::loadOtbm(const std::string& fileName)
 
 void Map::saveOtbm(const std::string& fileName)
 {
+    materializePendingTiles();
+
     try {
         FileStreamPtr fin = g_resources.createFile(fileName);
         if(!fin)
@@ -478,6 +480,8 @@ bool Map::loadOtcm(const std::string& fileName)
 
 void Map::saveOtcm(const std::string& fileName)
 {
+    materializePendingTiles();
+
     try {
         stdext::timer saveTimer;
 
@@ -35,6 +35,7 @@
 #include <framework/core/application.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/resourcemanager.h>
+#include <framework/graphics/drawqueue.h>
 #include <framework/graphics/framebuffermanager.h>
 #include <framework/graphics/graphics.h>
 #include <framework/graphics/image.h>
@@ -104,6 +105,8 @@ void MapView::draw(const Rect& rect)
             m_frameCache.flags |= Otc::FUpdateThing;
             g_painter->setColor(Color::black);
             g_painter->drawFilledRect(m_rectDimension);
+            g_painter->resetColor();
+            g_drawQueue.startRecording();
         }
 
         const auto& lightView = redrawLight ? m_lightView.get() : nullptr;
@@ -133,8 +136,11 @@ void MapView::draw(const Rect& rect)
             onFloorDrawingEnd(z);
         }
 
-        if(redrawThing)
+        if(redrawThing) {
+            g_drawQueue.stopRecording();
+            g_drawQueue.flush();
             m_frameCache.tile->release();
+        }
     }
 
     // generating mipmaps each frame can be slow in older cards
@@ -239,6 +245,10 @@ void MapView::drawCreatureInformation(const Rect& rect, Point drawOffset, const
             g_painter->setAlphaWriting(true);
             g_painter->clear(Color::alpha);
 
+            // bars, names and icons are queued and batched by layer, texture and color
+            g_drawQueue.startRecording();
+            g_drawQueue.lockDepth();
+
             for(const auto& creature : m_visibleCreatures) {
                 if(!creature->canBeSeen())
                     continue;
@@ -256,6 +266,9 @@ void MapView::drawCreatureInformation(const Rect& rect, Point drawOffset, const
                 creature->drawInformation(rect, flags);
             }
 
+            g_drawQueue.stopRecording();
+            g_drawQueue.flush();
+
             m_frameCache.creatureInformation->release();
             m_frameCache.creatureDynamicInformation->setDrawable(false);
         } else { // Dynamic Information
@@ -263,6 +276,9 @@ void MapView::drawCreatureInformation(const Rect& rect, Point drawOffset, const
             g_painter->setAlphaWriting(true);
             g_painter->clear(Color::alpha);
 
+            g_drawQueue.startRecording();
+            g_drawQueue.lockDepth();
+
             for(const auto& creature : m_visibleCreatures) {
                 if(!creature->canBeSeen())
                     continue;
@@ -272,6 +288,10 @@ void MapView::drawCreatureInformation(const Rect& rect, Point drawOffset, const
                 creature->updateDynamicInformation(false);
                 creature->drawInformation(rect, flags);
             }
+
+            g_drawQueue.stopRecording();
+            g_drawQueue.flush();
+
             m_frameCache.creatureDynamicInformation->release();
             m_frameCache.creatureDynamicInformation->setDrawable(true);
         }
@@ -294,6 +314,9 @@ void MapView::drawText(const Rect& rect, Point drawOffset, const float horizonta
             g_painter->setAlphaWriting(true);
             g_painter->clear(Color::alpha);
 
+            g_drawQueue.startRecording();
+            g_drawQueue.lockDepth();
+
             for(const StaticTextPtr& staticText : g_map.getStaticTexts()) {
                 const Position pos = staticText->getPosition();
 
@@ -306,12 +329,19 @@ void MapView::drawText(const Rect& rect, Point drawOffset, const float horizonta
                 p += rect.topLeft();
                 staticText->drawText(p, rect);
             }
+
+            g_drawQueue.stopRecording();
+            g_drawQueue.flush();
+
             m_frameCache.staticText->release();
         }
 
         m_frameCache.staticText->draw();
     }
 
+    g_drawQueue.startRecording();
+    g_drawQueue.lockDepth();
+
     for(const AnimatedTextPtr& animatedText : g_map.getAnimatedTexts()) {
         const Position pos = animatedText->getPosition();
 
@@ -325,6 +355,9 @@ void MapView::drawText(const Rect& rect, Point drawOffset, const float horizonta
 
         animatedText->drawText(p, rect);
     }
+
+    g_drawQueue.stopRecording();
+    g_drawQueue.flush();
 }
 
 void MapView::updateVisibleTilesCache()
@@ -357,6 +390,12 @@ void MapView::updateVisibleTilesCache()
     m_cachedFirstVisibleFloor = cachedFirstVisibleFloor;
     m_cachedLastVisibleFloor = cachedLastVisibleFloor;
 
+    // floors that were hidden when they arrived may be visible now
+    g_map.materializeFloors(m_cachedFirstVisibleFloor, m_cachedLastVisibleFloor);
+
+    if(m_lightView)
+        m_lightView->resetOcclusion();
+
     // clear current visible tiles cache
     do {
         m_cachedVisibleTiles[m_floorMin].clear();
@@ -535,7 +574,7 @@ void MapView::onFloorDrawingStart(const uint8 floor)
             shadowColor = Color(215, 0, .6f);
         }
 
-        g_painter->setColor(shadowColor);
+        g_drawQueue.setColor(shadowColor);
         m_lastFloorShadowingColor = shadowColor;
     }
 }
@@ -543,12 +582,15 @@ void MapView::onFloorDrawingStart(const uint8 floor)
 void MapView::onFloorDrawingEnd(const uint8 /*floor*/)
 {
     if(m_drawFloorShadowing) {
-        g_painter->resetColor();
+        g_drawQueue.resetColor();
     }
 }
 
 void MapView::onTileUpdate(const Position& pos, const ThingPtr& thing, const Otc::Operation operation)
 {
+    if(m_lightView)
+        m_lightView->invalidateOcclusion(pos);
+
     // Need Optimization (update only the specific Tile)
     if(Otc::OPERATION_CLEAN == operation) {
         m_forceTileUpdateCache = true;
@@ -739,37 +781,7 @@ uint8 MapView::calcFirstVisibleFloor()
                 if(cameraPosition.z > Otc::SEA_FLOOR)
                     firstFloor = std::max<uint8>(cameraPosition.z - Otc::AWARE_UNDEGROUND_FLOOR_RANGE, Otc::UNDERGROUND_FLOOR);
 
-                // loop in 3x3 tiles around the camera
-                for(int_fast32_t ix = -1; ix <= 1 && firstFloor < cameraPosition.z; ++ix) {
-                    for(int_fast32_t iy = -1; iy <= 1 && firstFloor < cameraPosition.z; ++iy) {
-                        const Position pos = cameraPosition.translated(ix, iy);
-
-                        // process tiles that we can look through, e.g. windows, doors
-                        if((ix == 0 && iy == 0) || ((std::abs(ix) != std::abs(iy)) && g_map.isLookPossible(pos))) {
-                            Position upperPos = pos;
-                            Position coveredPos = pos;
-
-                            const auto isLookPossible = g_map.isLookPossible(pos);
-                            while(coveredPos.coveredUp() && upperPos.up() && upperPos.z >= firstFloor) {
-                                // check tiles physically above
-                                TilePtr tile = g_map.getTile(upperPos);
-                                if(tile && tile->limitsFloorsView(!isLookPossible)) {
-                                    firstFloor = upperPos.z + 1;
-                                    break;
-                                }
-
-                                // check tiles geometrically above
-                                tile = g_map.getTile(coveredPos);
-                                if(tile && tile->limitsFloorsView(isLookPossible)) {
-                                    firstFloor = coveredPos.z + 1;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-
-                z = firstFloor;
+                z = calcFirstUncoveredFloor(cameraPosition, firstFloor);
             }
         }
     }
@@ -779,29 +791,84 @@ uint8 MapView::calcFirstVisibleFloor()
     return z;
 }
 
+// walks up from the camera until a tile limits the view, floors below firstFloor are
+// not looked at; pending tiles on the way are created since they decide what is visible
+uint8 MapView::calcFirstUncoveredFloor(const Position& cameraPosition, uint8 firstFloor)
+{
+    // loop in 3x3 tiles around the camera
+    for(int_fast32_t ix = -1; ix <= 1 && firstFloor < cameraPosition.z; ++ix) {
+        for(int_fast32_t iy = -1; iy <= 1 && firstFloor < cameraPosition.z; ++iy) {
+            const Position pos = cameraPosition.translated(ix, iy);
+
+            // process tiles that we can look through, e.g. windows, doors
+            if((ix == 0 && iy == 0) || ((std::abs(ix) != std::abs(iy)) && g_map.isLookPossible(pos))) {
+                Position upperPos = pos;
+                Position coveredPos = pos;
+
+                const auto isLookPossible = g_map.isLookPossible(pos);
+                while(coveredPos.coveredUp() && upperPos.up() && upperPos.z >= firstFloor) {
+                    // check tiles physically above
+                    TilePtr tile = g_map.materializeTile(upperPos);
+                    if(tile && tile->limitsFloorsView(!isLookPossible)) {
+                        firstFloor = upperPos.z + 1;
+                        break;
+                    }
+
+                    // check tiles geometrically above
+                    tile = g_map.materializeTile(coveredPos);
+                    if(tile && tile->limitsFloorsView(isLookPossible)) {
+                        firstFloor = coveredPos.z + 1;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return firstFloor;
+}
+
 uint8 MapView::calcLastVisibleFloor()
 {
     if(!m_multifloor)
         return calcFirstVisibleFloor();
 
-    uint8 z = Otc::SEA_FLOOR;
+    uint8 firstFloor, lastFloor;
+    getDrawableFloorRange(getCameraPosition(), firstFloor, lastFloor);
+    return lastFloor;
+}
+
+// floors the view can draw with the camera at the given position, the first one
+// is the highest possible, before tiles above the camera limit the view
+void MapView::getDrawableFloorRange(const Position& cameraPosition, uint8& firstFloor, uint8& lastFloor)
+{
+    int first = Otc::SEA_FLOOR, last = Otc::SEA_FLOOR;
 
-    const Position cameraPosition = getCameraPosition();
     // this could happens if the player is not known yet
     if(cameraPosition.isValid()) {
+        if(!m_multifloor)
+            first = cameraPosition.z;
+        else if(cameraPosition.z > Otc::SEA_FLOOR)
+            first = std::max<int>(cameraPosition.z - Otc::AWARE_UNDEGROUND_FLOOR_RANGE, Otc::UNDERGROUND_FLOOR);
+        else
+            first = 0;
+
         // view only underground floors when below sea level
         if(cameraPosition.z > Otc::SEA_FLOOR)
-            z = cameraPosition.z + Otc::AWARE_UNDEGROUND_FLOOR_RANGE;
-        else
-            z = Otc::SEA_FLOOR;
+            last = cameraPosition.z + Otc::AWARE_UNDEGROUND_FLOOR_RANGE;
     }
 
-    if(m_lockedFirstVisibleFloor != _UI8_MAX)
-        z = std::max<int>(m_lockedFirstVisibleFloor, z);
+    if(m_lockedFirstVisibleFloor != _UI8_MAX) {
+        first = m_lockedFirstVisibleFloor;
+        last = std::max<int>(m_lockedFirstVisibleFloor, last);
+    }
 
-    // just ensure the that the floor is in the valid range
-    z = stdext::clamp<int>(z, 0, static_cast<int>(Otc::MAX_Z));
-    return z;
+    if(!m_multifloor)
+        last = first;
+
+    // just ensure the that the floors are in the valid range
+    firstFloor = stdext::clamp<int>(first, 0, static_cast<int>(Otc::MAX_Z));
+    lastFloor = stdext::clamp<int>(std::max<int>(first, last), 0, static_cast<int>(Otc::MAX_Z));
 }
 
 Position MapView::getCameraPosition()
@@ -71,6 +71,7 @@ public:
     uint8 getLockedFirstVisibleFloor() { return m_lockedFirstVisibleFloor; }
     uint8 getCachedFirstVisibleFloor() { return m_cachedFirstVisibleFloor; }
     uint8 getCachedLastVisibleFloor() { return m_cachedLastVisibleFloor; }
+    void getDrawableFloorRange(const Position& cameraPosition, uint8& firstFloor, uint8& lastFloor);
     uint8 getTileSize() { return m_tileSize; }
 
     void lockFirstVisibleFloor(uint8 firstVisibleFloor);
@@ -179,6 +180,7 @@ private:
     void requestVisibleTilesCacheUpdate() { m_timeUpdateVisibleTilesCache.restart();  m_mustUpdateVisibleTilesCache = true; }
 
     uint8 calcFirstVisibleFloor();
+    uint8 calcFirstUncoveredFloor(const Position& cameraPosition, uint8 firstFloor);
     uint8 calcLastVisibleFloor();
 
     void updateLight();
@@ -28,7 +28,7 @@
 #include <framework/core/filestream.h>
 #include <framework/core/resourcemanager.h>
 #include <framework/graphics/framebuffermanager.h>
-#include <framework/graphics/image.h>
+#include <framework/graphics/graphics.h>
 #include <framework/graphics/image.h>
 #include <framework/graphics/painter.h>
 #include <framework/graphics/texture.h>
@@ -38,49 +38,54 @@ Minimap g_minimap;
 void MinimapBlock::clean()
 {
     m_tiles.fill(MinimapTile());
-    m_texture.reset();
-    m_mustUpdate = false;
+    mustUpdate();
 }
 
-void MinimapBlock::update()
+Rect MinimapBlock::update()
 {
     if(!m_mustUpdate)
-        return;
-
-    ImagePtr image(new Image(Size(MMBLOCK_SIZE, MMBLOCK_SIZE)));
+        return Rect();
 
-    bool shouldDraw = false;
-    for(int x = 0; x < MMBLOCK_SIZE; ++x) {
-        for(int y = 0; y < MMBLOCK_SIZE; ++y) {
-            const uint8 c = getTile(x, y).color;
-            uint32 col;
-            if(c != _UI8_MAX) {
-                col = Color::from8bit(c).rgba();
-                shouldDraw = true;
-            } else
-                col = Color::alpha.rgba();
-            image->setPixel(x, y, col);
-        }
+    static const auto palette = [] {
+        std::array<uint32, 256> colors;
+        for(int c = 0; c < _UI8_MAX; ++c)
+            colors[c] = Color::from8bit(c).rgba();
+        colors[_UI8_MAX] = Color::alpha.rgba();
+        return colors;
+    }();
+
+    if(!m_image) {
+        m_image = ImagePtr(new Image(Size(MMBLOCK_SIZE, MMBLOCK_SIZE)));
+        m_dirtyTop = 0;
+        m_dirtyBottom = MMBLOCK_SIZE;
     }
 
-    if(shouldDraw) {
-        if(!m_texture) {
-            m_texture = TexturePtr(new Texture(image, true));
-        } else {
-            m_texture->uploadPixels(image, true);
-        }
-    } else
-        m_texture.reset();
+    // only the changed rows are rebuilt, they are also all that gets uploaded
+    uint32* pixels = reinterpret_cast<uint32*>(m_image->getPixelData());
+    for(int y = m_dirtyTop; y < m_dirtyBottom; ++y) {
+        for(int x = 0; x < MMBLOCK_SIZE; ++x)
+            pixels[y * MMBLOCK_SIZE + x] = palette[m_tiles[y * MMBLOCK_SIZE + x].color];
+    }
 
+    const Rect dirtyRect(0, m_dirtyTop, MMBLOCK_SIZE, m_dirtyBottom - m_dirtyTop);
+    m_dirtyTop = MMBLOCK_SIZE;
+    m_dirtyBottom = 0;
     m_mustUpdate = false;
+    return dirtyRect;
 }
 
-void MinimapBlock::updateTile(int x, int y, const MinimapTile& tile)
+bool MinimapBlock::updateTile(int x, int y, const MinimapTile& tile)
 {
-    if(m_tiles[getTileIndex(x, y)].color != tile.color)
-        m_mustUpdate = true;
+    bool changed = false;
+    if(m_tiles[getTileIndex(x, y)].color != tile.color) {
+        m_mustUpdate = changed = true;
+        const int row = y % MMBLOCK_SIZE;
+        m_dirtyTop = std::min<int>(m_dirtyTop, row);
+        m_dirtyBottom = std::max<int>(m_dirtyBottom, row + 1);
+    }
 
     m_tiles[getTileIndex(x, y)] = tile;
+    return changed;
 }
 
 void Minimap::init()
@@ -94,8 +99,14 @@ void Minimap::terminate()
 
 void Minimap::clean()
 {
-    for(int i = 0; i <= Otc::MAX_Z; ++i)
+    for(int i = 0; i <= Otc::MAX_Z; ++i) {
         m_tileBlocks[i].clear();
+        for(auto& lods : m_lodBlocks[i])
+            lods.clear();
+    }
+
+    m_atlasPages.clear();
+    m_atlasSlots = 0;
 }
 
 void Minimap::draw(const Rect& screenRect, const Position& mapCenter, float scale, const Color& color)
@@ -115,40 +126,291 @@ void Minimap::draw(const Rect& screenRect, const Position& mapCenter, float scal
         return;
     }
 
-    const Point blockOff = getBlockOffset(mapRect.topLeft());
+    // far zoom outs draw merged blocks, so only a handful of quads are needed
+    const int level = getLodLevel(scale),
+        blockSize = getLodSize(level);
+
+    const Point blockOff = Point(mapRect.left() - mapRect.left() % blockSize, mapRect.top() - mapRect.top() % blockSize);
     const Point off = Point((mapRect.size() * scale).toPoint() - screenRect.size().toPoint()) / 2;
     const Point start = screenRect.topLeft() - (mapRect.topLeft() - blockOff) * scale - off;
 
-    for(int y = blockOff.y, ys = start.y; ys < screenRect.bottom(); y += MMBLOCK_SIZE, ys += MMBLOCK_SIZE * scale) {
+    for(MinimapAtlasPage& page : m_atlasPages)
+        page.coords.clear();
+
+    for(int y = blockOff.y, ys = start.y; ys < screenRect.bottom(); y += blockSize, ys += blockSize * scale) {
         if(y < 0 || y >= 65536)
             continue;
 
-        for(int x = blockOff.x, xs = start.x; xs < screenRect.right(); x += MMBLOCK_SIZE, xs += MMBLOCK_SIZE * scale) {
+        for(int x = blockOff.x, xs = start.x; xs < screenRect.right(); x += blockSize, xs += blockSize * scale) {
             if(x < 0 || x >= 65536)
                 continue;
 
-            Position blockPos(x, y, mapCenter.z);
-            if(!hasBlock(blockPos))
-                continue;
+            const Position blockPos(x, y, mapCenter.z);
+            const Rect dest(Point(xs, ys), Size(blockSize, blockSize) * scale);
+
+            // blocks are batched per atlas page, drawn after the loop
+            if(level == 0) {
+                if(!hasBlock(blockPos))
+                    continue;
 
-            MinimapBlock& block = getBlock(Position(x, y, mapCenter.z));
-            block.update();
+                Rect src;
+                const int page = updateBlock(getBlock(blockPos), src);
+                if(page >= 0)
+                    m_atlasPages[page].coords.addRect(dest, src);
+                continue;
+            }
 
-            const TexturePtr& tex = block.getTexture();
+            const TexturePtr& tex = getLodTexture(level, blockPos);
             if(tex) {
                 Rect src(0, 0, MMBLOCK_SIZE, MMBLOCK_SIZE);
-                Rect dest(Point(xs, ys), src.size() * scale);
 
-                tex->setSmooth(scale < 1.0f);
+                tex->setSmooth(blockSize / MMBLOCK_SIZE * scale < 1.0f);
                 g_painter->drawTexturedRect(dest, tex, src);
             }
-            //g_painter->drawBoundingRect(Rect(xs,ys, MMBLOCK_SIZE * scale, MMBLOCK_SIZE * scale));
+            //g_painter->drawBoundingRect(dest);
+        }
+    }
+
+    const bool smooth = scale < 1.0f;
+    for(MinimapAtlasPage& page : m_atlasPages) {
+        if(page.coords.getVertexCount() == 0)
+            continue;
+
+        // mipmaps are only rebuilt when they are going to be sampled
+        if(smooth && page.canUseMipmaps && page.mustBuildMipmaps) {
+            page.texture->buildHardwareMipmaps();
+            page.mustBuildMipmaps = false;
         }
+
+        page.texture->setSmooth(smooth);
+        g_painter->drawTextureCoords(page.coords, page.texture);
     }
 
     g_painter->restoreSavedState();
 }
 
+void MinimapTileBuilder::addItem(ThingType* type)
+{
+    // the last ground, top and bottom items are the ones the tile draws over the others
+    if(type->isGround() || type->isGroundBorder()) {
+        m_hasGroundToDraw = true;
+        if(type->isGround())
+            m_ground = type;
+    } else if(type->isOnTop())
+        m_topItem = type;
+    else if(type->isOnBottom())
+        m_bottomItem = type;
+
+    if(type->isNotWalkable())
+        m_notWalkable = true;
+    if(type->isNotPathable())
+        m_notPathable = true;
+}
+
+MinimapTile MinimapTileBuilder::build()
+{
+    MinimapTile minimapTile;
+    minimapTile.flags |= MinimapTileWasSeen;
+    if(m_notWalkable || !m_hasGroundToDraw)
+        minimapTile.flags |= MinimapTileNotWalkable;
+    if(m_notPathable)
+        minimapTile.flags |= MinimapTileNotPathable;
+
+    if(m_color != 0)
+        minimapTile.color = m_color;
+    else if(m_topItem && m_topItem->getMinimapColor() != 0)
+        minimapTile.color = m_topItem->getMinimapColor();
+    else if(m_bottomItem && m_bottomItem->getMinimapColor() != 0)
+        minimapTile.color = m_bottomItem->getMinimapColor();
+    else if(m_ground && m_ground->getMinimapColor() != 0)
+        minimapTile.color = m_ground->getMinimapColor();
+
+    const int groundSpeed = m_ground ? m_ground->getGroundSpeed() : 100;
+    minimapTile.speed = std::min<int>(static_cast<int>(std::ceil(groundSpeed / 10.0f)), _UI8_MAX);
+    return minimapTile;
+}
+
+// uploads the rows changed since the last draw to the block atlas slot, returns its page
+int Minimap::updateBlock(MinimapBlock& block, Rect& atlasRect)
+{
+    Rect dirtyRect = block.update();
+    if(!block.getImage())
+        return -1;
+
+    if(block.getAtlasSlot() < 0) {
+        block.setAtlasSlot(allocateAtlasSlot());
+        dirtyRect = Rect(0, 0, MMBLOCK_SIZE, MMBLOCK_SIZE);
+    }
+
+    const int slotsPerPage = m_atlasBlocksPerSide * m_atlasBlocksPerSide,
+        page = block.getAtlasSlot() / slotsPerPage,
+        slot = block.getAtlasSlot() % slotsPerPage;
+
+    // slots have a one texel gutter repeating the block edges, so smooth
+    // sampling at the block borders never reads the neighbour slots
+    const Point slotPos((slot % m_atlasBlocksPerSide) * MMATLAS_SLOT_SIZE, (slot / m_atlasBlocksPerSide) * MMATLAS_SLOT_SIZE);
+    atlasRect = Rect(slotPos + Point(1, 1), Size(MMBLOCK_SIZE, MMBLOCK_SIZE));
+
+    if(dirtyRect.isValid()) {
+        // the gutter rows above and below go along when the first or last row changed
+        const int top = dirtyRect.top() == 0 ? 0 : dirtyRect.top() + 1,
+            bottom = dirtyRect.bottom() == MMBLOCK_SIZE - 1 ? MMATLAS_SLOT_SIZE : dirtyRect.bottom() + 2;
+
+        const uint32* pixels = reinterpret_cast<const uint32*>(block.getImage()->getPixelData());
+        m_atlasUploadBuffer.resize((bottom - top) * MMATLAS_SLOT_SIZE);
+        uint32* out = m_atlasUploadBuffer.data();
+        for(int y = top; y < bottom; ++y) {
+            const uint32* row = pixels + stdext::clamp<int>(y - 1, 0, MMBLOCK_SIZE - 1) * MMBLOCK_SIZE;
+            *out++ = row[0];
+            out = std::copy(row, row + MMBLOCK_SIZE, out);
+            *out++ = row[MMBLOCK_SIZE - 1];
+        }
+
+        MinimapAtlasPage& atlasPage = m_atlasPages[page];
+        atlasPage.texture->uploadSubPixels(Rect(slotPos.x, slotPos.y + top, MMATLAS_SLOT_SIZE, bottom - top), reinterpret_cast<const uint8*>(m_atlasUploadBuffer.data()));
+        atlasPage.mustBuildMipmaps = true;
+    }
+
+    return page;
+}
+
+int Minimap::allocateAtlasSlot()
+{
+    // pages keep a power of two size, the texels past the last slot stay unused
+    const int pageSize = std::max<int>(MMATLAS_SLOT_SIZE, std::min<int>(MMATLAS_SIZE, g_graphics.getMaxTextureSize()));
+    if(m_atlasBlocksPerSide == 0)
+        m_atlasBlocksPerSide = pageSize / MMATLAS_SLOT_SIZE;
+
+    // slots are never given back, blocks only go away with clean()
+    if(m_atlasSlots % (m_atlasBlocksPerSide * m_atlasBlocksPerSide) == 0) {
+        m_atlasPages.emplace_back();
+        m_atlasPages.back().texture = TexturePtr(new Texture(Size(pageSize, pageSize)));
+
+        // slots start at even texels, so the first mipmap level still keeps each block
+        // inside its own slot and gutter, the next ones would mix neighbouring blocks
+        m_atlasPages.back().canUseMipmaps = m_atlasPages.back().texture->setMaxMipmapLevel(1);
+    }
+
+    return m_atlasSlots++;
+}
+
+int Minimap::getLodSize(int level)
+{
+    int size = MMBLOCK_SIZE;
+    while(level-- > 0)
+        size *= MMLOD_FACTOR;
+    return size;
+}
+
+int Minimap::getLodLevel(float scale)
+{
+    // the biggest level whose pixels are still no larger than a screen pixel
+    int level = 0;
+    while(level < MMLOD_LEVELS && getLodSize(level + 1) / MMBLOCK_SIZE * scale <= 1.0f)
+        ++level;
+    return level;
+}
+
+void Minimap::invalidateLod(const Position& pos)
+{
+    for(int level = 1; level <= MMLOD_LEVELS; ++level)
+        m_lodBlocks[pos.z][level - 1][getLodIndex(level, pos)].mustUpdate = true;
+}
+
+void Minimap::updateLod(MinimapLod& lod, int level, const Position& pos)
+{
+    if(!lod.mustUpdate)
+        return;
+
+    if(!lod.image)
+        lod.image = ImagePtr(new Image(Size(MMBLOCK_SIZE, MMBLOCK_SIZE)));
+
+    // every child shrinks into a MMLOD_FACTOR times smaller square, averaging its seen pixels
+    const int childSize = getLodSize(level - 1),
+        childPixels = MMBLOCK_SIZE / MMLOD_FACTOR;
+
+    bool shouldDraw = false;
+    for(int cy = 0; cy < MMLOD_FACTOR; ++cy) {
+        for(int cx = 0; cx < MMLOD_FACTOR; ++cx) {
+            const ImagePtr childImage = getLodImage(level - 1, Position(pos.x + cx * childSize, pos.y + cy * childSize, pos.z));
+
+            for(int py = 0; py < childPixels; ++py) {
+                for(int px = 0; px < childPixels; ++px) {
+                    int r = 0, g = 0, b = 0, count = 0;
+                    if(childImage) {
+                        for(int sy = 0; sy < MMLOD_FACTOR; ++sy) {
+                            for(int sx = 0; sx < MMLOD_FACTOR; ++sx) {
+                                const uint8* pixel = childImage->getPixel(px * MMLOD_FACTOR + sx, py * MMLOD_FACTOR + sy);
+                                if(pixel[3] == 0)
+                                    continue;
+                                r += pixel[0];
+                                g += pixel[1];
+                                b += pixel[2];
+                                ++count;
+                            }
+                        }
+                    }
+
+                    uint8 pixel[4] = { 0, 0, 0, 0 };
+                    if(count > 0) {
+                        pixel[0] = r / count;
+                        pixel[1] = g / count;
+                        pixel[2] = b / count;
+                        pixel[3] = 0xff;
+                        shouldDraw = true;
+                    }
+                    lod.image->setPixel(cx * childPixels + px, cy * childPixels + py, pixel);
+                }
+            }
+        }
+    }
+
+    if(shouldDraw) {
+        if(!lod.texture)
+            lod.texture = TexturePtr(new Texture(lod.image, true));
+        else
+            lod.texture->uploadPixels(lod.image, true);
+    } else
+        lod.texture.reset();
+
+    lod.mustUpdate = false;
+}
+
+ImagePtr Minimap::getLodImage(int level, const Position& pos)
+{
+    if(level == 0) {
+        if(!hasBlock(pos))
+            return nullptr;
+
+        // keeps the atlas in sync, the block rows are consumed here
+        MinimapBlock& block = getBlock(pos);
+        Rect atlasRect;
+        updateBlock(block, atlasRect);
+        return block.getImage();
+    }
+
+    auto& lods = m_lodBlocks[pos.z][level - 1];
+    const auto it = lods.find(getLodIndex(level, pos));
+    if(it == lods.end())
+        return nullptr;
+
+    updateLod(it->second, level, pos);
+    return it->second.image;
+}
+
+const TexturePtr& Minimap::getLodTexture(int level, const Position& pos)
+{
+    static TexturePtr nullTexture;
+
+    auto& lods = m_lodBlocks[pos.z][level - 1];
+    const auto it = lods.find(getLodIndex(level, pos));
+    if(it == lods.end())
+        return nullTexture;
+
+    updateLod(it->second, level, pos);
+    return it->second.texture;
+}
+
 Point Minimap::getTilePoint(const Position& pos, const Rect& screenRect, const Position& mapCenter, float scale)
 {
     if(screenRect.isEmpty() || pos.z != mapCenter.z)
@@ -194,19 +456,25 @@ void Minimap::updateTile(const Position& pos, const TilePtr& tile)
 {
     MinimapTile minimapTile;
     if(tile) {
-        minimapTile.color = tile->getMinimapColorByte();
-        minimapTile.flags |= MinimapTileWasSeen;
-        if(!tile->isWalkable(true))
-            minimapTile.flags |= MinimapTileNotWalkable;
-        if(!tile->isPathable())
-            minimapTile.flags |= MinimapTileNotPathable;
-        minimapTile.speed = std::min<int>(static_cast<int>(std::ceil(tile->getGroundSpeed() / 10.0f)), _UI8_MAX);
+        MinimapTileBuilder builder;
+        for(const ThingPtr& thing : tile->getThings()) {
+            if(thing->isItem())
+                builder.addItem(thing->rawGetThingType());
+        }
+        builder.overwriteColor(tile->getOverwrittenMinimapColor());
+        minimapTile = builder.build();
     }
 
+    updateTile(pos, minimapTile);
+}
+
+void Minimap::updateTile(const Position& pos, const MinimapTile& minimapTile)
+{
     if(minimapTile != MinimapTile()) {
         MinimapBlock& block = getBlock(pos);
         const Point offsetPos = getBlockOffset(Point(pos.x, pos.y));
-        block.updateTile(pos.x - offsetPos.x, pos.y - offsetPos.y, minimapTile);
+        if(block.updateTile(pos.x - offsetPos.x, pos.y - offsetPos.y, minimapTile))
+            invalidateLod(pos);
         block.justSaw();
     }
 }
@@ -288,6 +556,7 @@ bool Minimap::loadImage(const std::string& fileName, const Position& topLeft, fl
                     tile.color = c;
                     tile.flags = flags;
                     block.mustUpdate();
+                    invalidateLod(pos);
                 }
             }
         }
@@ -356,6 +625,7 @@ bool Minimap::loadOtmm(const std::string& fileName)
 
             memcpy((uchar*)&block.getTiles(), decompressBuffer.data(), blockSize);
             block.mustUpdate();
+            invalidateLod(pos);
             block.justSaw();
         }
 
@@ -25,10 +25,15 @@
 #define MINIMAP_H
 
 #include <framework/graphics/declarations.h>
+#include <framework/graphics/coordsbuffer.h>
 #include "declarations.h"
 
 enum {
     MMBLOCK_SIZE = 64,
+    MMLOD_LEVELS = 3,
+    MMLOD_FACTOR = 4,
+    MMATLAS_SIZE = 1024,
+    MMATLAS_SLOT_SIZE = MMBLOCK_SIZE + 2,
     OTMM_SIGNATURE = 0x4D4d544F,
     OTMM_VERSION = 1
 };
@@ -56,25 +61,67 @@ class MinimapBlock
 {
 public:
     void clean();
-    void update();
-    void updateTile(int x, int y, const MinimapTile& tile);
+    Rect update();
+    bool updateTile(int x, int y, const MinimapTile& tile);
     MinimapTile& getTile(int x, int y) { return m_tiles[getTileIndex(x, y)]; }
     void resetTile(int x, int y) { m_tiles[getTileIndex(x, y)] = MinimapTile(); }
     uint getTileIndex(int x, int y) { return ((y % MMBLOCK_SIZE) * MMBLOCK_SIZE) + (x % MMBLOCK_SIZE); }
-    const TexturePtr& getTexture() { return m_texture; }
+    const ImagePtr& getImage() { return m_image; }
     std::array<MinimapTile, MMBLOCK_SIZE* MMBLOCK_SIZE>& getTiles() { return m_tiles; }
-    void mustUpdate() { m_mustUpdate = true; }
+    void mustUpdate() { m_mustUpdate = true; m_dirtyTop = 0; m_dirtyBottom = MMBLOCK_SIZE; }
+    int getAtlasSlot() { return m_atlasSlot; }
+    void setAtlasSlot(int slot) { m_atlasSlot = slot; }
     void justSaw() { m_wasSeen = true; }
     bool wasSeen() { return m_wasSeen; }
 private:
-    TexturePtr m_texture;
+    ImagePtr m_image;
     std::array<MinimapTile, MMBLOCK_SIZE* MMBLOCK_SIZE> m_tiles;
+    int m_atlasSlot = -1;
+    // rows changed since the last update, bottom is exclusive
+    uint8 m_dirtyTop = 0;
+    uint8 m_dirtyBottom = MMBLOCK_SIZE;
     stdext::boolean<true> m_mustUpdate;
     stdext::boolean<false> m_wasSeen;
 };
 
 #pragma pack(pop)
 
+// derives what the minimap shows for a tile from its item types, added in stack order;
+// shared by created tiles and by tiles whose things are still pending
+class MinimapTileBuilder
+{
+public:
+    void addItem(ThingType* type);
+    void overwriteColor(uint8 color) { m_color = color; }
+    MinimapTile build();
+
+private:
+    ThingType* m_ground = nullptr;
+    ThingType* m_topItem = nullptr;
+    ThingType* m_bottomItem = nullptr;
+    uint8 m_color = 0;
+    stdext::boolean<false> m_hasGroundToDraw;
+    stdext::boolean<false> m_notWalkable;
+    stdext::boolean<false> m_notPathable;
+};
+
+// merged image of MMLOD_FACTOR x MMLOD_FACTOR nodes of the level below, drawn when zoomed out
+struct MinimapLod
+{
+    ImagePtr image;
+    TexturePtr texture;
+    stdext::boolean<true> mustUpdate;
+};
+
+// shared texture holding many blocks, drawn with one call per frame
+struct MinimapAtlasPage
+{
+    TexturePtr texture;
+    CoordsBuffer coords;
+    stdext::boolean<false> mustBuildMipmaps;
+    stdext::boolean<false> canUseMipmaps;
+};
+
 class Minimap
 {
 
@@ -90,6 +137,7 @@ public:
     Rect getTileRect(const Position& pos, const Rect& screenRect, const Position& mapCenter, float scale);
 
     void updateTile(const Position& pos, const TilePtr& tile);
+    void updateTile(const Position& pos, const MinimapTile& minimapTile);
     const MinimapTile& getTile(const Position& pos);
 
     bool loadImage(const std::string& fileName, const Position& topLeft, float colorFactor);
@@ -112,7 +160,26 @@ private:
                         (index / (65536 / MMBLOCK_SIZE)) * MMBLOCK_SIZE, z);
     }
     uint getBlockIndex(const Position& pos) { return ((pos.y / MMBLOCK_SIZE) * (65536 / MMBLOCK_SIZE)) + (pos.x / MMBLOCK_SIZE); }
+
+    // level 0 are the blocks, each level above covers MMLOD_FACTOR times more tiles per side
+    int getLodSize(int level);
+    uint getLodIndex(int level, const Position& pos) { const int size = getLodSize(level); return ((pos.y / size) * (65536 / size)) + (pos.x / size); }
+    int getLodLevel(float scale);
+    void invalidateLod(const Position& pos);
+    void updateLod(MinimapLod& lod, int level, const Position& pos);
+    ImagePtr getLodImage(int level, const Position& pos);
+    const TexturePtr& getLodTexture(int level, const Position& pos);
+    int updateBlock(MinimapBlock& block, Rect& atlasRect);
+    int allocateAtlasSlot();
+
     std::unordered_map<uint, MinimapBlock> m_tileBlocks[Otc::MAX_Z + 1];
+    std::unordered_map<uint, MinimapLod> m_lodBlocks[Otc::MAX_Z + 1][MMLOD_LEVELS];
+
+    // a deque so pages never move, coords buffers must not be copied
+    std::deque<MinimapAtlasPage> m_atlasPages;
+    int m_atlasSlots = 0;
+    int m_atlasBlocksPerSide = 0;
+    std::vector<uint32> m_atlasUploadBuffer;
 };
 
 extern Minimap g_minimap;
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "opcodeprofiler.h"
+#include <framework/core/resourcemanager.h>
+
+OpcodeProfiler g_opcodeProfiler;
+
+void OpcodeProfiler::reset()
+{
+    m_opcodes.fill(OpcodeStats());
+}
+
+std::map<std::string, double> OpcodeProfiler::getOpcodeStats(int opcode)
+{
+    std::map<std::string, double> ret;
+    if(opcode < 0 || opcode > 255)
+        return ret;
+
+    const OpcodeStats& stats = m_opcodes[opcode];
+    ret["count"] = stats.count;
+    ret["bytes"] = stats.bytes;
+    ret["total"] = stats.totalMicros;
+    ret["max"] = stats.maxMicros;
+    ret["lua"] = stats.luaMicros;
+    return ret;
+}
+
+std::vector<int> OpcodeProfiler::getProfiledOpcodes()
+{
+    std::vector<int> opcodes;
+    for(int opcode = 0; opcode < 256; ++opcode) {
+        if(m_opcodes[opcode].count > 0)
+            opcodes.push_back(opcode);
+    }
+    return opcodes;
+}
+
+std::string OpcodeProfiler::getReport()
+{
+    // most expensive opcodes first
+    std::vector<int> opcodes = getProfiledOpcodes();
+    std::sort(opcodes.begin(), opcodes.end(), [this](int a, int b) {
+        return m_opcodes[a].totalMicros > m_opcodes[b].totalMicros;
+    });
+
+    std::stringstream ss;
+    ss << "opcode\tcount\tbytes\ttotal_us\tavg_us\tmax_us\tlua_us\n";
+    for(int opcode : opcodes) {
+        const OpcodeStats& stats = m_opcodes[opcode];
+        ss << opcode << "\t"
+           << stats.count << "\t"
+           << stats.bytes << "\t"
+           << stats.totalMicros << "\t"
+           << (stats.totalMicros / (double)stats.count) << "\t"
+           << stats.maxMicros << "\t"
+           << stats.luaMicros << "\n";
+    }
+    return ss.str();
+}
+
+bool OpcodeProfiler::dump(const std::string& fileName)
+{
+    return g_resources.writeFileContents(fileName, getReport());
+}
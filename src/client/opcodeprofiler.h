@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef OPCODEPROFILER_H
+#define OPCODEPROFILER_H
+
+#include "declarations.h"
+
+// @bindsingleton g_opcodeProfiler
+class OpcodeProfiler
+{
+public:
+    struct OpcodeStats {
+        OpcodeStats() : count(0), bytes(0), totalMicros(0), maxMicros(0), luaMicros(0) { }
+        uint32 count;
+        uint64 bytes;
+        ticks_t totalMicros;
+        ticks_t maxMicros;
+        ticks_t luaMicros;
+    };
+
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() { return m_enabled; }
+    void reset();
+
+    void addParse(uint8 opcode, uint bytes, ticks_t micros) {
+        OpcodeStats& stats = m_opcodes[opcode];
+        stats.count++;
+        stats.bytes += bytes;
+        stats.totalMicros += micros;
+        if(micros > stats.maxMicros)
+            stats.maxMicros = micros;
+    }
+    void addLuaHook(uint8 opcode, ticks_t micros) { m_opcodes[opcode].luaMicros += micros; }
+
+    const OpcodeStats& getStats(uint8 opcode) { return m_opcodes[opcode]; }
+    std::map<std::string, double> getOpcodeStats(int opcode);
+    std::vector<int> getProfiledOpcodes();
+
+    std::string getReport();
+    bool dump(const std::string& fileName);
+
+private:
+    stdext::boolean<false> m_enabled;
+    std::array<OpcodeStats, 256> m_opcodes;
+};
+
+extern OpcodeProfiler g_opcodeProfiler;
+
+#endif
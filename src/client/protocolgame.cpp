@@ -26,6 +26,8 @@
 #include "localplayer.h"
 #include "player.h"
 
+std::bitset<256> ProtocolGame::m_luaOpcodes;
+
 void ProtocolGame::login(const std::string& accountName, const std::string& accountPassword, const std::string& host, uint16 port, const std::string& characterName, const std::string& authenticatorToken, const std::string& sessionKey)
 {
     m_accountName = accountName;
@@ -47,12 +49,24 @@ void ProtocolGame::onConnect()
     if(g_game.getFeature(Otc::GameProtocolChecksum))
         enableChecksum();
 
+    if(g_game.getFeature(Otc::GamePacketCompression))
+        enableCompression();
+
     if(!g_game.getFeature(Otc::GameChallengeOnLogin))
         sendLoginPacket(0, 0);
 
     recv();
 }
 
+void ProtocolGame::playRecord(const PacketPlayerPtr& player)
+{
+    m_firstRecv = true;
+    m_localPlayer = g_game.getLocalPlayer();
+
+    // recorded messages are already decrypted, there is nothing to send back
+    Protocol::playRecord(player);
+}
+
 void ProtocolGame::onRecv(const InputMessagePtr& inputMessage)
 {
     if(m_firstRecv) {
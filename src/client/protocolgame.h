@@ -28,11 +28,15 @@
 #include "declarations.h"
 #include "protocolcodes.h"
 
+#include <bitset>
+
 class ProtocolGame : public Protocol
 {
 public:
     void login(const std::string& accountName, const std::string& accountPassword, const std::string& host, uint16 port, const std::string& characterName, const std::string& authenticatorToken, const std::string& sessionKey);
     void send(const OutputMessagePtr& outputMessage) override;
+    void sendImmediately(const OutputMessagePtr& outputMessage);
+    void playRecord(const PacketPlayerPtr& player) override;
 
     void sendExtendedOpcode(uint8 opcode, const std::string& buffer);
     void sendLoginPacket(uint challengeTimestamp, uint8 challengeRandom);
@@ -123,6 +127,11 @@ public:
     // otclient only
     void sendChangeMapAwareRange(int xrange, int yrange);
 
+    // only opcodes hooked from lua are offered to the lua onOpcode callback
+    static void hookOpcode(uint8 opcode) { m_luaOpcodes.set(opcode); }
+    static void unhookOpcode(uint8 opcode) { m_luaOpcodes.reset(opcode); }
+    static bool isOpcodeHooked(uint8 opcode) { return m_luaOpcodes.test(opcode); }
+
 protected:
     void onConnect() override;
     void onRecv(const InputMessagePtr& inputMessage) override;
@@ -247,6 +256,7 @@ public:
     void setMapDescription(const InputMessagePtr& msg, int x, int y, int z, int width, int height);
     int setFloorDescription(const InputMessagePtr& msg, int x, int y, int z, int width, int height, int offset, int skip);
     int setTileDescription(const InputMessagePtr& msg, Position position);
+    int setTileDescription(const InputMessagePtr& msg, Position position, bool drawn);
 
     Outfit getOutfit(const InputMessagePtr& msg);
     ThingPtr getThing(const InputMessagePtr& msg);
@@ -254,6 +264,7 @@ public:
     CreaturePtr getCreature(const InputMessagePtr& msg, int type = 0);
     StaticTextPtr getStaticText(const InputMessagePtr& msg, int type = 0);
     ItemPtr getItem(const InputMessagePtr& msg, int id = 0);
+    PendingTileItem getPendingItem(const InputMessagePtr& msg, int id, int stackPos);
     Position getPosition(const InputMessagePtr& msg);
 
 private:
@@ -267,6 +278,8 @@ private:
     std::string m_sessionKey;
     std::string m_characterName;
     LocalPlayerPtr m_localPlayer;
+
+    static std::bitset<256> m_luaOpcodes;
 };
 
 #endif
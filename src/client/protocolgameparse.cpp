@@ -30,6 +30,7 @@
 #include "luavaluecasts.h"
 #include "map.h"
 #include "missile.h"
+#include "opcodeprofiler.h"
 #include "thingtypemanager.h"
 #include "tile.h"
 
@@ -38,9 +39,27 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
     int opcode = -1;
     int prevOpcode = -1;
 
+    // an opcode is accounted when the next one starts, handlers may return from many places,
+    // one that throws is accounted in the catch block
+    const bool profiling = g_opcodeProfiler.isEnabled();
+    int profiledOpcode = -1;
+    ticks_t opcodeStart = 0;
+    int opcodeReadPos = 0;
+
     try {
         while(!msg->eof()) {
+            if(profiling) {
+                const ticks_t now = stdext::micros();
+                if(profiledOpcode >= 0)
+                    g_opcodeProfiler.addParse(profiledOpcode, msg->getReadPos() - opcodeReadPos, now - opcodeStart);
+                profiledOpcode = -1;
+                opcodeStart = now;
+                opcodeReadPos = msg->getReadPos();
+            }
+
             opcode = msg->getU8();
+            if(profiling)
+                profiledOpcode = opcode;
 
             // must be > so extended will be enabled before GameStart.
             if(!g_game.getFeature(Otc::GameLoginPending)) {
@@ -50,12 +69,20 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
                 }
             }
 
-            // try to parse in lua first
-            const int readPos = msg->getReadPos();
-            if(callLuaField<bool>("onOpcode", opcode, msg))
-                continue;
-            msg->setReadPos(readPos);
-            // restore read pos
+            // try to parse in lua first, only for opcodes that have a lua handler
+            if(m_luaOpcodes.test(opcode)) {
+                const int readPos = msg->getReadPos();
+                if(profiling) {
+                    const ticks_t luaStart = stdext::micros();
+                    const bool handled = callLuaField<bool>("onOpcode", opcode, msg);
+                    g_opcodeProfiler.addLuaHook(opcode, stdext::micros() - luaStart);
+                    if(handled)
+                        continue;
+                } else if(callLuaField<bool>("onOpcode", opcode, msg))
+                    continue;
+                // restore read pos
+                msg->setReadPos(readPos);
+            }
 
             switch(opcode) {
             case Proto::GameServerLoginOrPendingState:
@@ -401,7 +428,12 @@ void ProtocolGame::parseMessage(const InputMessagePtr& msg)
             }
             prevOpcode = opcode;
         }
+
+        if(profiledOpcode >= 0)
+            g_opcodeProfiler.addParse(profiledOpcode, msg->getReadPos() - opcodeReadPos, stdext::micros() - opcodeStart);
     } catch(stdext::exception& e) {
+        if(profiledOpcode >= 0)
+            g_opcodeProfiler.addParse(profiledOpcode, msg->getReadPos() - opcodeReadPos, stdext::micros() - opcodeStart);
         g_logger.error(stdext::format("ProtocolGame parse message exception (%d bytes unread, last opcode is %d, prev opcode is %d): %s",
                                       msg->getUnreadSize(), opcode, prevOpcode, e.what()));
     }
@@ -2059,11 +2091,13 @@ void ProtocolGame::setMapDescription(const InputMessagePtr& msg, int x, int y, i
 
 int ProtocolGame::setFloorDescription(const InputMessagePtr& msg, int x, int y, int z, int width, int height, int offset, int skip)
 {
+    // the floors that may hide this one don't change while it is described
+    const bool drawn = g_map.isDrawingFloor(z);
     for(int nx = 0; nx < width; ++nx) {
         for(int ny = 0; ny < height; ++ny) {
             Position tilePos(x + nx + offset, y + ny + offset, z);
             if(skip == 0)
-                skip = setTileDescription(msg, tilePos);
+                skip = setTileDescription(msg, tilePos, drawn);
             else {
                 g_map.cleanTile(tilePos);
                 --skip;
@@ -2074,13 +2108,26 @@ int ProtocolGame::setFloorDescription(const InputMessagePtr& msg, int x, int y,
 }
 
 int ProtocolGame::setTileDescription(const InputMessagePtr& msg, Position position)
+{
+    return setTileDescription(msg, position, g_map.isDrawingFloor(position.z));
+}
+
+int ProtocolGame::setTileDescription(const InputMessagePtr& msg, Position position, bool drawn)
 {
     g_map.cleanTile(position);
 
+    // tiles on floors that no view is drawing are kept in a compact form,
+    // the map creates their things when something asks for the tile
+    bool materialize = drawn;
+    PendingTile pending;
+
+    int skip = 0;
     bool gotEffect = false;
     for(int stackPos = 0; stackPos < 256; ++stackPos) {
-        if(msg->peekU16() >= 0xff00)
-            return msg->getU16() & 0xff;
+        if(msg->peekU16() >= 0xff00) {
+            skip = msg->getU16() & 0xff;
+            break;
+        }
 
         if(g_game.getFeature(Otc::GameEnvironmentEffect) && !gotEffect) {
             msg->getU16(); // environment effect
@@ -2091,11 +2138,34 @@ int ProtocolGame::setTileDescription(const InputMessagePtr& msg, Position positi
         if(stackPos > 10)
             g_logger.traceError(stdext::format("too many things, pos=%s, stackpos=%d", stdext::to_string(position), stackPos));
 
+        if(!materialize) {
+            const int id = msg->getU16();
+            if(id != Proto::UnknownCreature && id != Proto::OutdatedCreature && id != Proto::Creature && id != Proto::StaticText) {
+                pending.push_back(getPendingItem(msg, id, stackPos));
+                continue;
+            }
+
+            // creatures and texts can't wait, so the whole tile is created now
+            materialize = true;
+            g_map.setPendingTile(position, std::move(pending));
+            g_map.materializeTile(position);
+            pending.clear();
+
+            if(id == Proto::StaticText)
+                g_map.addThing(getStaticText(msg, id), position, stackPos);
+            else
+                g_map.addThing(getCreature(msg, id), position, stackPos);
+            continue;
+        }
+
         ThingPtr thing = getThing(msg);
         g_map.addThing(thing, position, stackPos);
     }
 
-    return 0;
+    if(!pending.empty())
+        g_map.setPendingTile(position, std::move(pending));
+
+    return skip;
 }
 Outfit ProtocolGame::getOutfit(const InputMessagePtr& msg)
 {
@@ -2369,6 +2439,34 @@ ItemPtr ProtocolGame::getItem(const InputMessagePtr& msg, int id)
     return item;
 }
 
+PendingTileItem ProtocolGame::getPendingItem(const InputMessagePtr& msg, int id, int stackPos)
+{
+    // same layout as getItem, read through the item type without creating the item
+    if(!g_things.isValidDatId(id, ThingCategoryItem))
+        stdext::throw_exception(stdext::format("unable to create item with invalid id %d", id));
+
+    ThingType* type = g_things.rawGetThingType(id, ThingCategoryItem);
+
+    PendingTileItem item;
+    item.id = id;
+    item.countOrSubType = 1;
+    item.stackPos = stackPos;
+
+    if(g_game.getFeature(Otc::GameThingMarks)) {
+        msg->getU8(); // mark
+    }
+
+    if(type->isStackable() || type->isFluidContainer() || type->isSplash() || type->isChargeable())
+        item.countOrSubType = msg->getU8();
+
+    if(g_game.getFeature(Otc::GameItemAnimationPhase)) {
+        if(type->getAnimationPhases() > 1)
+            msg->getU8();
+    }
+
+    return item;
+}
+
 StaticTextPtr ProtocolGame::getStaticText(const InputMessagePtr& msg, int)
 {
     const int colorByte = msg->getU8();
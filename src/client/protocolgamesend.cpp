@@ -35,6 +35,14 @@ void ProtocolGame::send(const OutputMessagePtr& outputMessage)
     Protocol::send(outputMessage);
 }
 
+void ProtocolGame::sendImmediately(const OutputMessagePtr& outputMessage)
+{
+    // walk and combat actions skip the write delay, the latency of these is noticed
+    if(!g_game.checkBotProtection())
+        return;
+    Protocol::sendMessage(outputMessage, true);
+}
+
 void ProtocolGame::sendExtendedOpcode(uint8 opcode, const std::string& buffer)
 {
     if(m_enableSendExtendedOpcode) {
@@ -143,7 +151,7 @@ void ProtocolGame::sendPing()
     else {
         OutputMessagePtr msg(new OutputMessage);
         msg->addU8(Proto::ClientPing);
-        Protocol::send(msg);
+        Protocol::sendMessage(msg, true);
     }
 }
 
@@ -192,98 +200,98 @@ void ProtocolGame::sendAutoWalk(const std::vector<Otc::Direction>& path)
         }
         msg->addU8(byte);
     }
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendWalkNorth()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientWalkNorth);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendWalkEast()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientWalkEast);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendWalkSouth()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientWalkSouth);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendWalkWest()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientWalkWest);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendStop()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientStop);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendWalkNorthEast()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientWalkNorthEast);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendWalkSouthEast()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientWalkSouthEast);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendWalkSouthWest()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientWalkSouthWest);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendWalkNorthWest()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientWalkNorthWest);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendTurnNorth()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientTurnNorth);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendTurnEast()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientTurnEast);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendTurnSouth()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientTurnSouth);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendTurnWest()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientTurnWest);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendEquipItem(int itemId, int countOrSubType)
@@ -595,7 +603,7 @@ void ProtocolGame::sendAttack(uint creatureId, uint seq)
     msg->addU32(creatureId);
     if(g_game.getFeature(Otc::GameAttackSeq))
         msg->addU32(seq);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendFollow(uint creatureId, uint seq)
@@ -605,7 +613,7 @@ void ProtocolGame::sendFollow(uint creatureId, uint seq)
     msg->addU32(creatureId);
     if(g_game.getFeature(Otc::GameAttackSeq))
         msg->addU32(seq);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendInviteToParty(uint creatureId)
@@ -684,7 +692,7 @@ void ProtocolGame::sendCancelAttackAndFollow()
 {
     OutputMessagePtr msg(new OutputMessage);
     msg->addU8(Proto::ClientCancelAttackAndFollow);
-    send(msg);
+    sendImmediately(msg);
 }
 
 void ProtocolGame::sendRefreshContainer(int containerId)
@@ -28,6 +28,37 @@
 
 ShaderManager g_shaders;
 
+// u_Tex0 holds one texel per map tile: the light color with its radius in tiles / 4 as alpha,
+// followed by the same grid with the light center offset from the tile corner, in tiles / 4 + .5
+static const std::string glslLightMapFragmentShader = "\n\
+    varying mediump vec2 v_TexCoord;\n\
+    uniform lowp vec4 u_Color;\n\
+    uniform sampler2D u_Tex0;\n\
+    uniform highp vec2 u_MapSize;\n\
+    uniform highp vec2 u_TexSize;\n\
+    uniform lowp float u_BlendMax;\n\
+    lowp vec4 calculatePixel() {\n\
+        highp vec2 tile = v_TexCoord * u_TexSize;\n\
+        highp vec2 base = floor(tile);\n\
+        mediump vec3 light = u_Color.rgb;\n\
+        // the cpu keeps radius plus center offset within 4 tiles\n\
+        for(int x = -4; x <= 4; ++x) {\n\
+            for(int y = -4; y <= 4; ++y) {\n\
+                highp vec2 cell = base + vec2(float(x), float(y));\n\
+                if(cell.x < 0.0 || cell.y < 0.0 || cell.x >= u_MapSize.x || cell.y >= u_MapSize.y)\n\
+                    continue;\n\
+                lowp vec4 source = texture2D(u_Tex0, (cell + 0.5) / u_TexSize);\n\
+                if(source.a == 0.0)\n\
+                    continue;\n\
+                highp vec2 offset = (texture2D(u_Tex0, (cell + vec2(u_MapSize.x, 0.0) + 0.5) / u_TexSize).xy - 0.5) * 4.0;\n\
+                highp float falloff = clamp(1.0 - distance(tile, cell + offset) / (source.a * 4.0), 0.0, 1.0);\n\
+                mediump vec3 color = source.rgb * min(falloff * falloff, 0.4);\n\
+                light = mix(light + color, max(light, color), u_BlendMax);\n\
+            }\n\
+        }\n\
+        return vec4(light, 1.0);\n\
+    }\n";
+
 void ShaderManager::init()
 {
     if(!g_graphics.canUseShaders())
@@ -38,6 +69,9 @@ void ShaderManager::init()
 
     m_defaultMapShader = createFragmentShaderFromCode("Map", glslMainFragmentShader + glslTextureSrcFragmentShader);
 
+    m_lightMapShader = createFragmentShaderFromCode("LightMap", glslMainFragmentShader + glslLightMapFragmentShader);
+    setupLightMapShader(m_lightMapShader);
+
     PainterShaderProgram::release();
 }
 
@@ -45,6 +79,7 @@ void ShaderManager::terminate()
 {
     m_defaultItemShader = nullptr;
     m_defaultMapShader = nullptr;
+    m_lightMapShader = nullptr;
     m_shaders.clear();
 }
 
@@ -136,6 +171,15 @@ void ShaderManager::setupMapShader(const PainterShaderProgramPtr& shader)
     shader->bindUniformLocation(MAP_ZOOM, "u_MapZoom");
 }
 
+void ShaderManager::setupLightMapShader(const PainterShaderProgramPtr& shader)
+{
+    if(!shader)
+        return;
+    shader->bindUniformLocation(LIGHT_MAP_SIZE, "u_MapSize");
+    shader->bindUniformLocation(LIGHT_TEXTURE_SIZE, "u_TexSize");
+    shader->bindUniformLocation(LIGHT_BLEND_MAX, "u_BlendMax");
+}
+
 PainterShaderProgramPtr ShaderManager::getShader(const std::string& name)
 {
     const auto it = m_shaders.find(name);
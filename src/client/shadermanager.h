@@ -34,7 +34,10 @@ public:
         ITEM_ID_UNIFORM = 10,
         MAP_CENTER_COORD = 10,
         MAP_GLOBAL_COORD = 11,
-        MAP_ZOOM = 12
+        MAP_ZOOM = 12,
+        LIGHT_MAP_SIZE = 10,
+        LIGHT_TEXTURE_SIZE = 11,
+        LIGHT_BLEND_MAX = 12
     };
 
     void init();
@@ -49,15 +52,18 @@ public:
 
     const PainterShaderProgramPtr& getDefaultItemShader() { return m_defaultItemShader; }
     const PainterShaderProgramPtr& getDefaultMapShader() { return m_defaultMapShader; }
+    const PainterShaderProgramPtr& getLightMapShader() { return m_lightMapShader; }
 
     PainterShaderProgramPtr getShader(const std::string& name);
 
 private:
     static void setupItemShader(const PainterShaderProgramPtr& shader);
     static void setupMapShader(const PainterShaderProgramPtr& shader);
+    static void setupLightMapShader(const PainterShaderProgramPtr& shader);
 
     PainterShaderProgramPtr m_defaultItemShader;
     PainterShaderProgramPtr m_defaultMapShader;
+    PainterShaderProgramPtr m_lightMapShader;
     std::unordered_map<std::string, PainterShaderProgramPtr> m_shaders;
 };
 
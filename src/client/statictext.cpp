@@ -24,6 +24,7 @@
 #include <framework/core/clock.h>
 #include <framework/core/eventdispatcher.h>
 #include <framework/graphics/fontmanager.h>
+#include <framework/graphics/drawqueue.h>
 #include <framework/graphics/graphics.h>
 #include "map.h"
 
@@ -44,7 +45,7 @@ void StaticText::drawText(const Point& dest, const Rect& parentRect)
 
     // draw only if the real center is not too far from the parent center, or its a yell
     //if(g_map.isAwareOfPosition(m_position) || isYell()) {
-    g_painter->setColor(m_color);
+    g_drawQueue.setColor(m_color);
     m_cachedText.draw(boundRect);
     //}
 }
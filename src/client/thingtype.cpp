@@ -28,6 +28,7 @@
 
 #include <framework/core/eventdispatcher.h>
 #include <framework/core/filestream.h>
+#include <framework/graphics/drawqueue.h>
 #include <framework/graphics/graphics.h>
 #include <framework/graphics/image.h>
 #include <framework/graphics/texture.h>
@@ -465,12 +466,12 @@ void ThingType::draw(const Position& pos, const Point& dest, float scaleFactor,
         const bool useOpacity = m_opacity < 1.0f;
 
         if(useOpacity)
-            g_painter->setColor(Color(1.0f, 1.0f, 1.0f, m_opacity));
+            g_drawQueue.setColor(Color(1.0f, 1.0f, 1.0f, m_opacity));
 
-        g_painter->drawTexturedRect(screenRect, texture, textureRect);
+        g_drawQueue.drawTexturedRect(screenRect, texture, textureRect);
 
         if(useOpacity)
-            g_painter->resetColor();
+            g_drawQueue.resetColor();
     }
 
     if(lightView && hasLight() && frameFlags & Otc::FUpdateLight) {
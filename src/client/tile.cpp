@@ -22,6 +22,7 @@
 
 #include "tile.h"
 #include <framework/graphics/fontmanager.h>
+#include <framework/graphics/drawqueue.h>
 #include "effect.h"
 #include "game.h"
 #include "item.h"
@@ -97,7 +98,7 @@ void Tile::drawStart(const MapViewPtr& mapView)
     }
 
     if(mapView->isDrawingLights() && mapView->isDrawingFloorShadowing() && hasBorderShadowColor()) {
-        g_painter->setColor(m_borderShadowColor);
+        g_drawQueue.setColor(m_borderShadowColor);
     }
 }
 
@@ -107,7 +108,7 @@ void Tile::drawEnd(const MapViewPtr& mapView)
 
     // Reset Border Shadow Color
     if(mapView->isDrawingFloorShadowing() && hasBorderShadowColor()) {
-        g_painter->setColor(m_shadowColor);
+        g_drawQueue.setColor(m_shadowColor);
     }
 }
 
@@ -126,10 +127,10 @@ void Tile::drawThing(const ThingPtr& thing, const Point& dest, float scaleFactor
         }
     }
 
-    const auto putShadowColor = g_painter->getColor() == m_borderShadowColor && (!thing->isGroundBorder() && !thing->isTall());
+    const auto putShadowColor = g_drawQueue.getColor() == m_borderShadowColor && (!thing->isGroundBorder() && !thing->isTall());
 
     if(putShadowColor) {
-        g_painter->setColor(m_shadowColor);
+        g_drawQueue.setColor(m_shadowColor);
     }
 
     if(thing->isEffect()) {
@@ -144,7 +145,7 @@ void Tile::drawThing(const ThingPtr& thing, const Point& dest, float scaleFactor
 
     // Reset Border Shadow Color
     if(putShadowColor) {
-        g_painter->setColor(m_borderShadowColor);
+        g_drawQueue.setColor(m_borderShadowColor);
     }
 }
 
@@ -481,30 +482,6 @@ int Tile::getGroundSpeed()
     return 100;
 }
 
-uint8 Tile::getMinimapColorByte()
-{
-    if(m_minimapColor != 0)
-        return m_minimapColor;
-
-    if(!m_topItems.empty()) {
-        const uint8 c = m_topItems.back()->getMinimapColor();
-        if(c != 0) return c;
-    }
-
-    if(!m_bottomItems.empty()) {
-        const uint8 c = m_bottomItems.back()->getMinimapColor();
-        if(c != 0) return c;
-    }
-
-    const auto& ground = getGround();
-    if(ground) {
-        const uint8 c = ground->getMinimapColor();
-        if(c != 0) return c;
-    }
-
-    return 255; // alpha
-}
-
 ThingPtr Tile::getTopLookThing()
 {
     if(isEmpty()) return nullptr;
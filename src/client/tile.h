@@ -99,7 +99,6 @@ public:
     std::vector<ItemPtr> getItems();
     ItemPtr getGround();
     int getGroundSpeed();
-    uint8 getMinimapColorByte();
     int getThingCount() { return m_things.size() + m_effects.size(); }
     bool isPathable();
     bool isWalkable(bool ignoreCreatures = false);
@@ -121,6 +120,7 @@ public:
     int getElevation() const;
     bool hasElevation(int elevation = 1);
     void overwriteMinimapColor(uint8 color) { m_minimapColor = color; }
+    uint8 getOverwrittenMinimapColor() { return m_minimapColor; }
 
     bool isCompletelyCovered(int firstFloor = -1);
 
@@ -35,6 +35,10 @@ void UICreature::drawSelf(Fw::DrawPane drawPane)
         const Rect drawRect = getPaddingRect();
         g_painter->setColor(m_imageColor);
         m_creature->drawOutfit(drawRect, !m_fixedCreatureSize);
+
+        // animated outfits keep a cached parent repainting
+        if(m_creature->isOutfitAnimated())
+            invalidateRenderCache();
     }
 }
 
@@ -44,6 +48,7 @@ void UICreature::setOutfit(const Outfit& outfit)
         m_creature = CreaturePtr(new Creature);
     m_creature->setDirection(Otc::South);
     m_creature->setOutfit(outfit);
+    invalidateRenderCache();
 }
 
 void UICreature::onStyleApply(const std::string& styleName, const OTMLNodePtr& styleNode)
@@ -32,8 +32,8 @@ class UICreature : public UIWidget
 public:
     void drawSelf(Fw::DrawPane drawPane) override;
 
-    void setCreature(const CreaturePtr& creature) { m_creature = creature; }
-    void setFixedCreatureSize(bool fixed) { m_fixedCreatureSize = fixed; }
+    void setCreature(const CreaturePtr& creature) { m_creature = creature; invalidateRenderCache(); }
+    void setFixedCreatureSize(bool fixed) { m_fixedCreatureSize = fixed; invalidateRenderCache(); }
     void setOutfit(const Outfit& outfit);
 
     CreaturePtr getCreature() { return m_creature; }
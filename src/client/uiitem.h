@@ -34,11 +34,11 @@ public:
     void drawSelf(Fw::DrawPane drawPane) override;
 
     void setItemId(int id);
-    void setItemCount(int count) { if(m_item) m_item->setCount(count); }
-    void setItemSubType(int subType) { if(m_item) m_item->setSubType(subType); }
-    void setItemVisible(bool visible) { m_itemVisible = visible; }
-    void setItem(const ItemPtr& item) { m_item = item; }
-    void setVirtual(bool virt) { m_virtual = virt; }
+    void setItemCount(int count) { if(m_item) m_item->setCount(count); invalidateRenderCache(); }
+    void setItemSubType(int subType) { if(m_item) m_item->setSubType(subType); invalidateRenderCache(); }
+    void setItemVisible(bool visible) { m_itemVisible = visible; invalidateRenderCache(); }
+    void setItem(const ItemPtr& item) { m_item = item; invalidateRenderCache(); }
+    void setVirtual(bool virt) { m_virtual = virt; invalidateRenderCache(); }
     void clearItem() { setItemId(0); }
 
     int getItemId() { return m_item ? m_item->getId() : 0; }
@@ -23,6 +23,7 @@
 #include "uimap.h"
 #include <framework/graphics/graphics.h>
 #include <framework/otml/otml.h>
+#include "benchmark.h"
 #include "game.h"
 #include "localplayer.h"
 #include "map.h"
@@ -66,7 +67,12 @@ void UIMap::drawSelf(Fw::DrawPane drawPane)
 
     if(drawPane & Fw::BackgroundPane) {
         g_painter->resetColor();
-        m_mapView->draw(m_mapRect);
+        if(g_benchmark.isRunning()) {
+            const ticks_t drawStart = stdext::micros();
+            m_mapView->draw(m_mapRect);
+            g_benchmark.addMapDraw(stdext::micros() - drawStart);
+        } else
+            m_mapView->draw(m_mapRect);
     }
 }
 
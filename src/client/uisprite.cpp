@@ -71,6 +71,7 @@ void UISprite::setSpriteId(int id)
         else
             m_sprite = nullptr;
     }
+    invalidateRenderCache();
 }
 
 void UISprite::onStyleApply(const std::string& styleName, const OTMLNodePtr& styleNode)
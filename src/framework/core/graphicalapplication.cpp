@@ -54,6 +54,10 @@ void GraphicalApplication::init(std::vector<std::string>& args)
     // initialize ui
     g_ui.init();
 
+    // graphics options must be known before the painter is selected
+    for(uint i = 1; i < args.size(); ++i)
+        g_graphics.parseOption(args[i]);
+
     // initialize graphics
     g_graphics.init();
 
@@ -99,6 +99,22 @@ void BitmapFont::calculateDrawTextCoords(CoordsBuffer& coordsBuffer, const std::
     if(!screenCoords.isValid() || !m_texture)
         return;
 
+    static GlyphQuads glyphQuads;
+    calculateGlyphQuads(glyphQuads, text, screenCoords.size(), align);
+
+    for(const auto& quad : glyphQuads)
+        coordsBuffer.addRect(quad.first.translated(screenCoords.topLeft()), quad.second);
+}
+
+void BitmapFont::calculateGlyphQuads(GlyphQuads& glyphQuads, const std::string& text, const Size& boxSize, Fw::AlignmentFlag align)
+{
+    glyphQuads.clear();
+
+    // prevent glitches from invalid boxes
+    const Rect boxCoords(Point(0, 0), boxSize);
+    if(!boxCoords.isValid() || !m_texture)
+        return;
+
     int textLenght = text.length();
 
     // map glyphs positions
@@ -118,17 +134,17 @@ void BitmapFont::calculateDrawTextCoords(CoordsBuffer& coordsBuffer, const std::
 
         // first translate to align position
         if(align & Fw::AlignBottom) {
-            glyphScreenCoords.translate(0, screenCoords.height() - textBoxSize.height());
+            glyphScreenCoords.translate(0, boxSize.height() - textBoxSize.height());
         } else if(align & Fw::AlignVerticalCenter) {
-            glyphScreenCoords.translate(0, (screenCoords.height() - textBoxSize.height()) / 2);
+            glyphScreenCoords.translate(0, (boxSize.height() - textBoxSize.height()) / 2);
         } else { // AlignTop
             // nothing to do
         }
 
         if(align & Fw::AlignRight) {
-            glyphScreenCoords.translate(screenCoords.width() - textBoxSize.width(), 0);
+            glyphScreenCoords.translate(boxSize.width() - textBoxSize.width(), 0);
         } else if(align & Fw::AlignHorizontalCenter) {
-            glyphScreenCoords.translate((screenCoords.width() - textBoxSize.width()) / 2, 0);
+            glyphScreenCoords.translate((boxSize.width() - textBoxSize.width()) / 2, 0);
         } else { // AlignLeft
             // nothing to do
         }
@@ -139,33 +155,29 @@ void BitmapFont::calculateDrawTextCoords(CoordsBuffer& coordsBuffer, const std::
 
         // bound glyph topLeft to 0,0 if needed
         if(glyphScreenCoords.top() < 0) {
-            glyphTextureCoords.setTop(glyphTextureCoords.top() - glyphScreenCoords.top());
+            glyphTextureCoords.setTop(glyphTextureCoords.top() - glyphScreenCoords.top() * m_glyphsTextureScale);
             glyphScreenCoords.setTop(0);
         }
         if(glyphScreenCoords.left() < 0) {
-            glyphTextureCoords.setLeft(glyphTextureCoords.left() - glyphScreenCoords.left());
+            glyphTextureCoords.setLeft(glyphTextureCoords.left() - glyphScreenCoords.left() * m_glyphsTextureScale);
             glyphScreenCoords.setLeft(0);
         }
 
-        // translate rect to screen coords
-        glyphScreenCoords.translate(screenCoords.topLeft());
-
-        // only render if glyph rect is visible on screenCoords
-        if(!screenCoords.intersects(glyphScreenCoords))
+        // only render if glyph rect is visible inside the box
+        if(!boxCoords.intersects(glyphScreenCoords))
             continue;
 
-        // bound glyph bottomRight to screenCoords bottomRight
-        if(glyphScreenCoords.bottom() > screenCoords.bottom()) {
-            glyphTextureCoords.setBottom(glyphTextureCoords.bottom() + (screenCoords.bottom() - glyphScreenCoords.bottom()));
-            glyphScreenCoords.setBottom(screenCoords.bottom());
+        // bound glyph bottomRight to box bottomRight
+        if(glyphScreenCoords.bottom() > boxCoords.bottom()) {
+            glyphTextureCoords.setBottom(glyphTextureCoords.bottom() + (boxCoords.bottom() - glyphScreenCoords.bottom()) * m_glyphsTextureScale);
+            glyphScreenCoords.setBottom(boxCoords.bottom());
         }
-        if(glyphScreenCoords.right() > screenCoords.right()) {
-            glyphTextureCoords.setRight(glyphTextureCoords.right() + (screenCoords.right() - glyphScreenCoords.right()));
-            glyphScreenCoords.setRight(screenCoords.right());
+        if(glyphScreenCoords.right() > boxCoords.right()) {
+            glyphTextureCoords.setRight(glyphTextureCoords.right() + (boxCoords.right() - glyphScreenCoords.right()) * m_glyphsTextureScale);
+            glyphScreenCoords.setRight(boxCoords.right());
         }
 
-        // render glyph
-        coordsBuffer.addRect(glyphScreenCoords, glyphTextureCoords);
+        glyphQuads.emplace_back(glyphScreenCoords, glyphTextureCoords);
     }
 }
 
@@ -279,7 +291,7 @@ void BitmapFont::calculateGlyphsWidthsAutomatically(const ImagePtr& image, const
             int filledPixels = 0;
             // check if all vertical pixels are alpha
             for(int y = glyphCoords.top(); y <= glyphCoords.bottom(); ++y) {
-                if(texturePixels[(y * image->getSize().width() * 4) + (x*4) + 3] != 0)
+                if(texturePixels[(y * image->getSize().width() * 4) + (x*4) + 3] > m_glyphsAlphaThreshold)
                     filledPixels++;
             }
             if(filledPixels > 0)
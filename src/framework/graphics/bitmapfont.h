@@ -32,7 +32,9 @@
 class BitmapFont : public stdext::shared_object
 {
 public:
-    BitmapFont(const std::string& name) : m_name(name) { }
+    typedef std::vector<std::pair<Rect, Rect>> GlyphQuads;
+
+    BitmapFont(const std::string& name) : m_name(name), m_glyphsTextureScale(1.0f), m_glyphsAlphaThreshold(0) { }
 
     /// Load font from otml node
     void load(const OTMLNodePtr& fontNode);
@@ -45,6 +47,9 @@ public:
 
     void calculateDrawTextCoords(CoordsBuffer& coordsBuffer, const std::string& text, const Rect& screenCoords, Fw::AlignmentFlag align = Fw::AlignTopLeft);
 
+    /// Layout glyphs (screen and texture coords) inside a box placed at 0,0, so they can be translated later
+    void calculateGlyphQuads(GlyphQuads& glyphQuads, const std::string& text, const Size& boxSize, Fw::AlignmentFlag align = Fw::AlignTopLeft);
+
     /// Calculate glyphs positions to use on render, also calculates textBoxSize if wanted
     const std::vector<Point>& calculateGlyphsPositions(const std::string& text,
                                                        Fw::AlignmentFlag align = Fw::AlignTopLeft,
@@ -62,8 +67,9 @@ public:
     const TexturePtr& getTexture() { return m_texture; }
     int getYOffset() { return m_yOffset; }
     Size getGlyphSpacing() { return m_glyphSpacing; }
+    virtual bool isDistanceField() { return false; }
 
-private:
+protected:
     /// Calculates each font character by inspecting font bitmap
     void calculateGlyphsWidthsAutomatically(const ImagePtr& image, const Size& glyphSize);
 
@@ -75,6 +81,8 @@ private:
     TexturePtr m_texture;
     Rect m_glyphsTextureCoords[256];
     Size m_glyphsSize[256];
+    float m_glyphsTextureScale; // texture pixels per screen pixel
+    uint8 m_glyphsAlphaThreshold; // minimum alpha of a glyph pixel when calculating widths
 };
 
 
@@ -22,6 +22,7 @@
 
 #include "cachedtext.h"
 #include "painter.h"
+#include "drawqueue.h"
 #include "fontmanager.h"
 #include "bitmapfont.h"
 
@@ -33,19 +34,39 @@ CachedText::CachedText()
 
 void CachedText::draw(const Rect& rect)
 {
-    if (!m_font)
+    if (!m_font || !m_font->getTexture())
         return;
 
-    if (m_textMustRecache || m_textCachedScreenCoords != rect) {
+    // glyphs are laid out once relative to the rect origin,
+    // moving the text only translates them
+    if (m_textMustRecache || m_textCachedSize != rect.size()) {
         m_textMustRecache = false;
-        m_textCachedScreenCoords = rect;
+        m_textCachedSize = rect.size();
+        m_coordsMustRecache = true;
+
+        m_font->calculateGlyphQuads(m_glyphQuads, m_text, m_textCachedSize, Fw::AlignCenter);
+    }
+
+    const TexturePtr& texture = m_font->getTexture();
+    const Point position = rect.topLeft();
+
+    // when recording, glyphs sharing font and color are batched together by the queue
+    if (g_drawQueue.isRecording()) {
+        for (const auto& quad : m_glyphQuads)
+            g_drawQueue.drawTexturedRect(quad.first.translated(position), texture, quad.second);
+        return;
+    }
+
+    if (m_coordsMustRecache || m_textCachedPosition != position) {
+        m_coordsMustRecache = false;
+        m_textCachedPosition = position;
 
         m_textCoordsBuffer.clear();
-        m_font->calculateDrawTextCoords(m_textCoordsBuffer, m_text, rect, Fw::AlignCenter);
+        for (const auto& quad : m_glyphQuads)
+            m_textCoordsBuffer.addRect(quad.first.translated(position), quad.second);
     }
 
-    if (m_font->getTexture())
-        g_painter->drawTextureCoords(m_textCoordsBuffer, m_font->getTexture());
+    g_painter->drawTextureCoords(m_textCoordsBuffer, texture);
 }
 
 void CachedText::update()
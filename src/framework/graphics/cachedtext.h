@@ -25,6 +25,7 @@
 
 #include "declarations.h"
 #include "coordsbuffer.h"
+#include "bitmapfont.h"
 
 class CachedText
 {
@@ -49,8 +50,11 @@ private:
     std::string m_text;
     Size m_textSize;
     stdext::boolean<true> m_textMustRecache;
+    stdext::boolean<true> m_coordsMustRecache;
+    BitmapFont::GlyphQuads m_glyphQuads;
     CoordsBuffer m_textCoordsBuffer;
-    Rect m_textCachedScreenCoords;
+    Size m_textCachedSize;
+    Point m_textCachedPosition;
     BitmapFontPtr m_font;
     Fw::AlignmentFlag m_align;
 };
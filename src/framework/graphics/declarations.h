@@ -31,13 +31,14 @@ class TextureManager;
 class Image;
 class AnimatedTexture;
 class BitmapFont;
+class DistanceFieldFont;
 class CachedText;
 class FrameBuffer;
 class FrameBufferManager;
 class Shader;
 class ShaderProgram;
 class PainterShaderProgram;
-class Particle;
+class ParticleGroup;
 class ParticleType;
 class ParticleEmitter;
 class ParticleAffector;
@@ -49,12 +50,12 @@ typedef stdext::shared_object_ptr<Image> ImagePtr;
 typedef stdext::shared_object_ptr<Texture> TexturePtr;
 typedef stdext::shared_object_ptr<AnimatedTexture> AnimatedTexturePtr;
 typedef stdext::shared_object_ptr<BitmapFont> BitmapFontPtr;
+typedef stdext::shared_object_ptr<DistanceFieldFont> DistanceFieldFontPtr;
 typedef stdext::shared_object_ptr<CachedText> CachedTextPtr;
 typedef stdext::shared_object_ptr<FrameBuffer> FrameBufferPtr;
 typedef stdext::shared_object_ptr<Shader> ShaderPtr;
 typedef stdext::shared_object_ptr<ShaderProgram> ShaderProgramPtr;
 typedef stdext::shared_object_ptr<PainterShaderProgram> PainterShaderProgramPtr;
-typedef stdext::shared_object_ptr<Particle> ParticlePtr;
 typedef stdext::shared_object_ptr<ParticleType> ParticleTypePtr;
 typedef stdext::shared_object_ptr<ParticleEmitter> ParticleEmitterPtr;
 typedef stdext::shared_object_ptr<ParticleAffector> ParticleAffectorPtr;
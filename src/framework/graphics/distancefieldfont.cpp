@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "distancefieldfont.h"
+#include "texture.h"
+
+#include <framework/otml/otml.h>
+
+DistanceFieldFont::DistanceFieldFont(const std::string& name) : BitmapFont(name)
+{
+    // pixels above half alpha are inside the glyph
+    m_glyphsAlphaThreshold = 127;
+}
+
+void DistanceFieldFont::load(const OTMLNodePtr& fontNode)
+{
+    BitmapFont::load(fontNode);
+
+    // distances must be interpolated between texels
+    if(m_texture) {
+        m_texture->setSmooth(true);
+        m_texture->setDistanceField(true);
+    }
+}
+
+DistanceFieldFontPtr DistanceFieldFont::scaled(const std::string& name, int height)
+{
+    DistanceFieldFontPtr font(new DistanceFieldFont(name));
+    const float scale = height / static_cast<float>(m_glyphHeight);
+
+    font->m_glyphHeight = height;
+    font->m_firstGlyph = m_firstGlyph;
+    font->m_yOffset = stdext::round(m_yOffset * scale);
+    font->m_glyphSpacing = Size(stdext::round(m_glyphSpacing.width() * scale), stdext::round(m_glyphSpacing.height() * scale));
+    font->m_texture = m_texture;
+    font->m_glyphsTextureScale = m_glyphsTextureScale / scale;
+
+    for(int glyph = 0; glyph < 256; ++glyph) {
+        const int width = m_glyphsSize[glyph].width();
+        font->m_glyphsSize[glyph] = Size(width > 0 ? std::max<int>(1, stdext::round(width * scale)) : 0, height);
+        font->m_glyphsTextureCoords[glyph] = m_glyphsTextureCoords[glyph];
+    }
+
+    return font;
+}
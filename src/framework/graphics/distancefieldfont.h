@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#ifndef DISTANCEFIELDFONT_H
+#define DISTANCEFIELDFONT_H
+
+#include "bitmapfont.h"
+
+/**
+ * Font whose atlas stores the distance to the glyph edges instead of the glyph pixels,
+ * a single atlas is rendered crisply at any size by the painter distance field shader.
+ */
+class DistanceFieldFont : public BitmapFont
+{
+public:
+    DistanceFieldFont(const std::string& name);
+
+    void load(const OTMLNodePtr& fontNode);
+
+    /// Create a font sharing this atlas with glyphs scaled to the given height
+    DistanceFieldFontPtr scaled(const std::string& name, int height);
+
+    bool isDistanceField() { return true; }
+};
+
+#endif
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "drawqueue.h"
+
+DrawQueue g_drawQueue;
+
+DrawQueue::DrawQueue()
+{
+    m_color = Color::white;
+    m_savedColor = Color::white;
+    m_compositionMode = Painter::CompositionMode_Normal;
+    m_savedCompositionMode = Painter::CompositionMode_Normal;
+    m_blendEquation = Painter::BlendEquation_Add;
+    m_savedBlendEquation = Painter::BlendEquation_Add;
+    m_depth = 0;
+    m_layer = 0;
+}
+
+void DrawQueue::startRecording()
+{
+    m_color = m_savedColor = g_painter->getColor();
+    m_compositionMode = m_savedCompositionMode = g_painter->getCompositionMode();
+    m_blendEquation = m_savedBlendEquation = g_painter->getBlendEquation();
+    m_recording = true;
+}
+
+void DrawQueue::stopRecording()
+{
+    m_recording = false;
+    m_depthLocked = false;
+    m_layer = 0;
+}
+
+void DrawQueue::clear()
+{
+    m_commands.clear();
+    m_depth = 0;
+    m_mustSort = false;
+}
+
+void DrawQueue::flush()
+{
+    m_lastStats = Stats();
+    m_lastStats.commands = m_commands.size();
+    if(m_commands.empty())
+        return;
+
+    // only commands sharing a locked depth can change places,
+    // the ones with their own depth are already in order
+    if(m_mustSort) {
+        std::stable_sort(m_commands.begin(), m_commands.end(), [](const DrawCommand& a, const DrawCommand& b) {
+            if(a.depth != b.depth)
+                return a.depth < b.depth;
+            if(a.layer != b.layer)
+                return a.layer < b.layer;
+            if(a.compositionMode != b.compositionMode)
+                return a.compositionMode < b.compositionMode;
+            if(a.blendEquation != b.blendEquation)
+                return a.blendEquation < b.blendEquation;
+            if(a.texture != b.texture)
+                return a.texture.get() < b.texture.get();
+            return a.color.rgba() < b.color.rgba();
+        });
+    }
+
+    // textured commands always carry a texture and fills never do,
+    // so comparing textures also keeps both kinds apart
+    const auto canBatch = [](const DrawCommand& a, const DrawCommand& b) -> bool {
+        return a.compositionMode == b.compositionMode && a.blendEquation == b.blendEquation &&
+               a.color == b.color && a.texture == b.texture;
+    };
+
+    Texture* lastTexture = nullptr;
+    for(auto it = m_commands.cbegin(); it != m_commands.cend();) {
+        auto last = it + 1;
+        while(last != m_commands.cend() && canBatch(*it, *last))
+            ++last;
+
+        if(it->texture && it->texture.get() != lastTexture) {
+            lastTexture = it->texture.get();
+            ++m_lastStats.textureBinds;
+        }
+
+        submit(it, last);
+        it = last;
+    }
+
+    g_painter->setColor(m_savedColor);
+    g_painter->setCompositionMode(m_savedCompositionMode);
+    g_painter->setBlendEquation(m_savedBlendEquation);
+
+    clear();
+}
+
+void DrawQueue::submit(std::vector<DrawCommand>::const_iterator begin, std::vector<DrawCommand>::const_iterator end)
+{
+    const DrawCommand& first = *begin;
+
+    if(g_painter->getCompositionMode() != first.compositionMode) {
+        g_painter->setCompositionMode(first.compositionMode);
+        ++m_lastStats.stateChanges;
+    }
+
+    if(g_painter->getBlendEquation() != first.blendEquation) {
+        g_painter->setBlendEquation(first.blendEquation);
+        ++m_lastStats.stateChanges;
+    }
+
+    if(g_painter->getColor() != first.color) {
+        g_painter->setColor(first.color);
+        ++m_lastStats.stateChanges;
+    }
+
+    m_coordsBuffer.clear();
+    if(first.texture) {
+        for(auto it = begin; it != end; ++it)
+            m_coordsBuffer.addRect(it->dest, it->src);
+        g_painter->drawTextureCoords(m_coordsBuffer, first.texture);
+    } else {
+        for(auto it = begin; it != end; ++it) {
+            if(it->type == BoundingRect)
+                m_coordsBuffer.addBoudingRect(it->dest, it->lineWidth);
+            else
+                m_coordsBuffer.addRect(it->dest);
+        }
+        g_painter->drawFillCoords(m_coordsBuffer);
+    }
+
+    ++m_lastStats.drawCalls;
+}
+
+void DrawQueue::setColor(const Color& color)
+{
+    if(!m_recording) {
+        g_painter->setColor(color);
+        return;
+    }
+
+    m_color = color;
+}
+
+Color DrawQueue::getColor()
+{
+    return m_recording ? m_color : g_painter->getColor();
+}
+
+void DrawQueue::setCompositionMode(Painter::CompositionMode compositionMode)
+{
+    if(!m_recording) {
+        g_painter->setCompositionMode(compositionMode);
+        return;
+    }
+
+    m_compositionMode = compositionMode;
+}
+
+Painter::CompositionMode DrawQueue::getCompositionMode()
+{
+    return m_recording ? m_compositionMode : g_painter->getCompositionMode();
+}
+
+void DrawQueue::setBlendEquation(Painter::BlendEquation blendEquation)
+{
+    if(!m_recording) {
+        g_painter->setBlendEquation(blendEquation);
+        return;
+    }
+
+    m_blendEquation = blendEquation;
+}
+
+Painter::BlendEquation DrawQueue::getBlendEquation()
+{
+    return m_recording ? m_blendEquation : g_painter->getBlendEquation();
+}
+
+void DrawQueue::drawTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src)
+{
+    if(!m_recording) {
+        g_painter->drawTexturedRect(dest, texture, src);
+        return;
+    }
+
+    if(dest.isEmpty() || src.isEmpty() || texture->isEmpty())
+        return;
+
+    DrawCommand& command = addCommand(TexturedRect, dest);
+    command.src = src;
+    command.texture = texture;
+}
+
+void DrawQueue::drawFilledRect(const Rect& dest)
+{
+    if(!m_recording) {
+        g_painter->drawFilledRect(dest);
+        return;
+    }
+
+    if(dest.isEmpty())
+        return;
+
+    addCommand(FilledRect, dest);
+}
+
+void DrawQueue::drawBoundingRect(const Rect& dest, int innerLineWidth)
+{
+    if(!m_recording) {
+        g_painter->drawBoundingRect(dest, innerLineWidth);
+        return;
+    }
+
+    if(dest.isEmpty() || innerLineWidth == 0)
+        return;
+
+    DrawCommand& command = addCommand(BoundingRect, dest);
+    command.lineWidth = innerLineWidth;
+}
+
+void DrawQueue::addLightSource(const Point& center, int radius, const TexturePtr& texture)
+{
+    const Rect dest(center - Point(radius, radius), Size(radius * 2, radius * 2));
+    if(!m_recording) {
+        g_painter->drawTexturedRect(dest, texture);
+        return;
+    }
+
+    if(dest.isEmpty() || texture->isEmpty())
+        return;
+
+    DrawCommand& command = addCommand(LightSource, dest);
+    command.src = Rect(Point(0, 0), texture->getSize());
+    command.texture = texture;
+}
+
+DrawQueue::DrawCommand& DrawQueue::addCommand(CommandType type, const Rect& dest)
+{
+    if(m_depthLocked)
+        m_mustSort = true;
+    else
+        ++m_depth;
+
+    m_commands.emplace_back();
+
+    DrawCommand& command = m_commands.back();
+    command.type = type;
+    command.compositionMode = m_compositionMode;
+    command.blendEquation = m_blendEquation;
+    command.lineWidth = 0;
+    command.depth = m_depth;
+    command.layer = m_layer;
+    command.dest = dest;
+    command.color = m_color;
+    return command;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DRAWQUEUE_H
+#define DRAWQUEUE_H
+
+#include "declarations.h"
+#include "painter.h"
+
+// Retained list of draw commands. While recording, draws are stored together
+// with the painter state they need and submitted later by flush(), which sorts
+// and batches them. When not recording every call goes straight to g_painter,
+// so drawing code does not need a separate immediate path.
+class DrawQueue
+{
+public:
+    enum CommandType : uint8 {
+        TexturedRect,
+        FilledRect,
+        BoundingRect,
+        LightSource
+    };
+
+    struct DrawCommand {
+        CommandType type;
+        Painter::CompositionMode compositionMode;
+        Painter::BlendEquation blendEquation;
+        uint16 lineWidth;
+        uint32 depth;
+        uint8 layer;
+        Rect dest;
+        Rect src;
+        Color color;
+        TexturePtr texture;
+    };
+
+    struct Stats {
+        uint32 commands = 0;
+        uint32 drawCalls = 0;
+        uint32 textureBinds = 0;
+        uint32 stateChanges = 0;
+    };
+
+    DrawQueue();
+
+    void startRecording();
+    void stopRecording();
+    bool isRecording() { return m_recording; }
+
+    void flush();
+    void clear();
+
+    // commands sharing a locked depth are free to be reordered by flush,
+    // otherwise each command gets its own depth and keeps the drawing order
+    void lockDepth() { ++m_depth; m_depthLocked = true; }
+    void unlockDepth() { m_depthLocked = false; }
+    uint32 getDepth() { return m_depth; }
+
+    // inside a locked depth lower layers are always drawn first,
+    // so e.g. bar backgrounds of every creature stay below every bar
+    void setLayer(uint8 layer) { m_layer = layer; }
+    void resetLayer() { m_layer = 0; }
+
+    void setColor(const Color& color);
+    Color getColor();
+    void resetColor() { setColor(Color::white); }
+
+    void setCompositionMode(Painter::CompositionMode compositionMode);
+    Painter::CompositionMode getCompositionMode();
+    void resetCompositionMode() { setCompositionMode(Painter::CompositionMode_Normal); }
+
+    void setBlendEquation(Painter::BlendEquation blendEquation);
+    Painter::BlendEquation getBlendEquation();
+    void resetBlendEquation() { setBlendEquation(Painter::BlendEquation_Add); }
+
+    void drawTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src);
+    void drawTexturedRect(const Rect& dest, const TexturePtr& texture) { drawTexturedRect(dest, texture, Rect(Point(0, 0), texture->getSize())); }
+    void drawFilledRect(const Rect& dest);
+    void drawBoundingRect(const Rect& dest, int innerLineWidth = 1);
+    void addLightSource(const Point& center, int radius, const TexturePtr& texture);
+
+    const std::vector<DrawCommand>& getCommands() { return m_commands; }
+    const Stats& getLastStats() { return m_lastStats; }
+
+private:
+    DrawCommand& addCommand(CommandType type, const Rect& dest);
+    void submit(std::vector<DrawCommand>::const_iterator begin, std::vector<DrawCommand>::const_iterator end);
+
+    std::vector<DrawCommand> m_commands;
+    CoordsBuffer m_coordsBuffer;
+    Color m_color;
+    Color m_savedColor;
+    Painter::CompositionMode m_compositionMode;
+    Painter::CompositionMode m_savedCompositionMode;
+    Painter::BlendEquation m_blendEquation;
+    Painter::BlendEquation m_savedBlendEquation;
+    uint32 m_depth;
+    uint8 m_layer;
+    Stats m_lastStats;
+    stdext::boolean<false> m_recording;
+    stdext::boolean<false> m_depthLocked;
+    stdext::boolean<false> m_mustSort;
+};
+
+extern DrawQueue g_drawQueue;
+
+#endif
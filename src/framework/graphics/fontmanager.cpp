@@ -36,12 +36,14 @@ FontManager::FontManager()
 void FontManager::terminate()
 {
     m_fonts.clear();
+    m_scaledFonts.clear();
     m_defaultFont = nullptr;
 }
 
 void FontManager::clearFonts()
 {
     m_fonts.clear();
+    m_scaledFonts.clear();
     m_defaultFont = BitmapFontPtr(new BitmapFont("emptyfont"));
 }
 
@@ -63,8 +65,18 @@ bool FontManager::importFont(std::string file)
             }
         }
 
-        BitmapFontPtr font(new BitmapFont(name));
-        font->load(fontNode);
+        // sizes of a replaced distance field font are scaled again on demand
+        m_scaledFonts.clear();
+
+        BitmapFontPtr font;
+        if(fontNode->valueAt("type", std::string("bitmap")) == "distance-field") {
+            DistanceFieldFontPtr distanceFieldFont(new DistanceFieldFont(name));
+            distanceFieldFont->load(fontNode);
+            font = distanceFieldFont;
+        } else {
+            font = BitmapFontPtr(new BitmapFont(name));
+            font->load(fontNode);
+        }
         m_fonts.push_back(font);
 
         // set as default if needed
@@ -84,7 +96,7 @@ bool FontManager::fontExists(const std::string& fontName)
         if(font->getName() == fontName)
             return true;
     }
-    return false;
+    return getScaledFont(fontName) != nullptr;
 }
 
 BitmapFontPtr FontManager::getFont(const std::string& fontName)
@@ -95,7 +107,40 @@ BitmapFontPtr FontManager::getFont(const std::string& fontName)
             return font;
     }
 
+    if(BitmapFontPtr font = getScaledFont(fontName))
+        return font;
+
     // when not found, fallback to default font
     g_logger.error(stdext::format("font '%s' not found", fontName));
     return getDefaultFont();
 }
+
+BitmapFontPtr FontManager::getScaledFont(const std::string& fontName)
+{
+    auto it = m_scaledFonts.find(fontName);
+    if(it != m_scaledFonts.end())
+        return it->second;
+
+    // distance field fonts can be requested at any height as '<name>-<height>px'
+    if(!stdext::ends_with(fontName, "px"))
+        return nullptr;
+
+    const size_t pos = fontName.rfind('-');
+    if(pos == std::string::npos)
+        return nullptr;
+
+    const std::string baseName = fontName.substr(0, pos);
+    const int height = stdext::unsafe_cast<int>(fontName.substr(pos + 1, fontName.length() - pos - 3), 0);
+    if(height <= 0)
+        return nullptr;
+
+    for(const BitmapFontPtr& font : m_fonts) {
+        if(font->getName() != baseName || !font->isDistanceField())
+            continue;
+
+        BitmapFontPtr scaledFont = font->static_self_cast<DistanceFieldFont>()->scaled(fontName, height);
+        m_scaledFonts[fontName] = scaledFont;
+        return scaledFont;
+    }
+    return nullptr;
+}
@@ -24,6 +24,7 @@
 #define FONTMANAGER_H
 
 #include "bitmapfont.h"
+#include "distancefieldfont.h"
 
 //@bindsingleton g_fonts
 class FontManager
@@ -43,7 +44,10 @@ public:
     void setDefaultFont(const std::string& fontName) { m_defaultFont = getFont(fontName); }
 
 private:
+    BitmapFontPtr getScaledFont(const std::string& fontName);
+
     std::vector<BitmapFontPtr> m_fonts;
+    std::unordered_map<std::string, BitmapFontPtr> m_scaledFonts;
     BitmapFontPtr m_defaultFont;
 };
 
@@ -42,3 +42,10 @@ FrameBufferPtr FrameBufferManager::createFrameBuffer()
     m_framebuffers.push_back(fbo);
     return fbo;
 }
+
+void FrameBufferManager::removeFrameBuffer(const FrameBufferPtr& frameBuffer)
+{
+    auto it = std::find(m_framebuffers.begin(), m_framebuffers.end(), frameBuffer);
+    if(it != m_framebuffers.end())
+        m_framebuffers.erase(it);
+}
@@ -34,6 +34,7 @@ public:
     void clear();
 
     FrameBufferPtr createFrameBuffer();
+    void removeFrameBuffer(const FrameBufferPtr& frameBuffer);
     const FrameBufferPtr& getTemporaryFrameBuffer() { return m_temporaryFramebuffer; }
 
 protected:
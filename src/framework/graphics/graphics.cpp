@@ -35,6 +35,8 @@
 #include "dx/painterdx9.h"
 #endif
 
+#include "null/painternull.h"
+
 #include <framework/graphics/graphics.h>
 #include <framework/graphics/texture.h>
 #include "texturemanager.h"
@@ -86,6 +88,9 @@ void Graphics::init()
         g_painterOGL2 = new PainterOGL2;
 #endif
 
+    // the null painter never touches the driver, it's only selected on demand
+    g_painterNull = new PainterNull;
+
     // blending is always enabled
     glEnable(GL_BLEND);
 
@@ -129,6 +134,11 @@ void Graphics::terminate()
     }
 #endif
 
+    if(g_painterNull) {
+        delete g_painterNull;
+        g_painterNull = nullptr;
+    }
+
     g_painter = nullptr;
 
     m_ok = false;
@@ -158,6 +168,8 @@ bool Graphics::parseOption(const std::string& option)
         m_prefferedPainterEngine = Painter_OpenGL1;
     else if(option == "-opengl2")
         m_prefferedPainterEngine = Painter_OpenGL2;
+    else if(option == "-null-painter")
+        m_prefferedPainterEngine = Painter_Null;
     else
         return false;
     return true;
@@ -179,6 +191,9 @@ bool Graphics::isPainterEngineAvailable(Graphics::PainterEngine painterEngine)
     if(g_painterOGL1 && painterEngine == Painter_OpenGL1)
         return true;
 #endif
+
+    if(g_painterNull && painterEngine == Painter_Null)
+        return true;
     return false;
 }
 
@@ -188,6 +203,17 @@ bool Graphics::selectPainterEngine(PainterEngine painterEngine)
     Painter *fallbackPainter = nullptr;
     PainterEngine fallbackPainterEngine = Painter_Any;
 
+    // when started with -null-painter it must stay selected, otherwise the
+    // options module would switch back to a real painter during startup
+    if(m_prefferedPainterEngine == Painter_Null)
+        painterEngine = Painter_Null;
+
+    // the null painter is never used as a fallback, only when explicitly asked
+    if(g_painterNull && painterEngine == Painter_Null) {
+        m_selectedPainterEngine = Painter_Null;
+        painter = g_painterNull;
+    }
+
 #ifdef PAINTER_DX9
     // use this to force directx if its enabled (avoid changes in options module, etc, will be removed)
     painterEngine = Painter_DirectX9;
@@ -262,6 +288,9 @@ void Graphics::resize(const Size& size)
     if(g_painterOGL2)
         g_painterOGL2->setResolution(size);
 #endif
+
+    if(g_painterNull)
+        g_painterNull->setResolution(size);
 }
 
 bool Graphics::canUseDrawArrays()
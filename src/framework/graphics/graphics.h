@@ -36,7 +36,8 @@ public:
         Painter_Any = 0,
         Painter_OpenGL1,
         Painter_OpenGL2,
-        Painter_DirectX9
+        Painter_DirectX9,
+        Painter_Null
     };
 
     // @dontbind
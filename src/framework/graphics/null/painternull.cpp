@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "painternull.h"
+#include <framework/platform/platformwindow.h>
+
+PainterNull* g_painterNull = nullptr;
+
+PainterNull::PainterNull()
+{
+    m_oldStateIndex = 0;
+    m_transformDepth = 0;
+    m_shaderProgram = nullptr;
+    m_texture = nullptr;
+    resetState();
+    setResolution(g_window.getSize());
+}
+
+void PainterNull::resetState()
+{
+    m_color = Color::white;
+    m_opacity = 1.0f;
+    m_compositionMode = CompositionMode_Normal;
+    m_blendEquation = BlendEquation_Add;
+    m_clipRect = Rect();
+    m_shaderProgram = nullptr;
+    m_texture = nullptr;
+    m_alphaWriting = false;
+}
+
+void PainterNull::saveState()
+{
+    assert(m_oldStateIndex < 10);
+    PainterState& state = m_olderStates[m_oldStateIndex];
+    state.color = m_color;
+    state.opacity = m_opacity;
+    state.compositionMode = m_compositionMode;
+    state.blendEquation = m_blendEquation;
+    state.clipRect = m_clipRect;
+    state.texture = m_texture;
+    state.shaderProgram = m_shaderProgram;
+    state.alphaWriting = m_alphaWriting;
+    m_oldStateIndex++;
+}
+
+void PainterNull::saveAndResetState()
+{
+    saveState();
+    resetState();
+}
+
+void PainterNull::restoreSavedState()
+{
+    m_oldStateIndex--;
+    const PainterState& state = m_olderStates[m_oldStateIndex];
+    setColor(state.color);
+    setOpacity(state.opacity);
+    setCompositionMode(state.compositionMode);
+    setBlendEquation(state.blendEquation);
+    setClipRect(state.clipRect);
+    setShaderProgram(state.shaderProgram);
+    setTexture(state.texture);
+    setAlphaWriting(state.alphaWriting);
+}
+
+void PainterNull::countDraw(int vertexCount, DrawMode drawMode)
+{
+    if(vertexCount == 0)
+        return;
+
+    ++m_stats.drawCalls;
+    m_stats.vertices += vertexCount;
+    if(drawMode == TriangleStrip)
+        m_stats.quads += std::max<int>(vertexCount - 2, 0) / 2;
+    else
+        m_stats.quads += vertexCount / 6;
+}
+
+void PainterNull::drawCoords(CoordsBuffer& coordsBuffer, DrawMode drawMode)
+{
+    const bool textured = coordsBuffer.getTextureCoordCount() > 0 && m_texture;
+
+    // skip drawing of empty textures, like the real painters do
+    if(textured && m_texture->isEmpty())
+        return;
+
+    countDraw(coordsBuffer.getVertexCount(), drawMode);
+}
+
+void PainterNull::drawFillCoords(CoordsBuffer& coordsBuffer)
+{
+    setTexture(nullptr);
+    drawCoords(coordsBuffer);
+}
+
+void PainterNull::drawTextureCoords(CoordsBuffer& coordsBuffer, const TexturePtr& texture)
+{
+    if(texture && texture->isEmpty())
+        return;
+
+    setTexture(texture.get());
+    drawCoords(coordsBuffer);
+}
+
+void PainterNull::drawTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src)
+{
+    if(dest.isEmpty() || src.isEmpty() || texture->isEmpty())
+        return;
+
+    setTexture(texture.get());
+    countDraw(4, TriangleStrip);
+}
+
+void PainterNull::drawUpsideDownTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src)
+{
+    drawTexturedRect(dest, texture, src);
+}
+
+void PainterNull::drawRepeatedTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src)
+{
+    if(dest.isEmpty() || src.isEmpty() || texture->isEmpty())
+        return;
+
+    setTexture(texture.get());
+
+    const int columns = (dest.width() + src.width() - 1) / src.width();
+    const int rows = (dest.height() + src.height() - 1) / src.height();
+    countDraw(columns * rows * 6, Triangles);
+}
+
+void PainterNull::drawFilledRect(const Rect& dest)
+{
+    if(dest.isEmpty())
+        return;
+
+    setTexture(nullptr);
+    countDraw(6, Triangles);
+}
+
+void PainterNull::drawFilledTriangle(const Point& a, const Point& b, const Point& c)
+{
+    if(a == b || a == c || b == c)
+        return;
+
+    setTexture(nullptr);
+    countDraw(3, Triangles);
+}
+
+void PainterNull::drawBoundingRect(const Rect& dest, int innerLineWidth)
+{
+    if(dest.isEmpty() || innerLineWidth == 0)
+        return;
+
+    // four borders, each one a quad
+    setTexture(nullptr);
+    countDraw(4 * 6, Triangles);
+}
+
+void PainterNull::setTexture(Texture* texture)
+{
+    if(m_texture == texture)
+        return;
+
+    m_texture = texture;
+    if(texture)
+        ++m_stats.textureBinds;
+}
+
+void PainterNull::setClipRect(const Rect& clipRect)
+{
+    if(m_clipRect == clipRect)
+        return;
+
+    m_clipRect = clipRect;
+    ++m_stats.stateChanges;
+}
+
+void PainterNull::setColor(const Color& color)
+{
+    if(m_color == color)
+        return;
+
+    m_color = color;
+    ++m_stats.stateChanges;
+}
+
+void PainterNull::setAlphaWriting(bool enable)
+{
+    if(m_alphaWriting == enable)
+        return;
+
+    m_alphaWriting = enable;
+    ++m_stats.stateChanges;
+}
+
+void PainterNull::setBlendEquation(BlendEquation blendEquation)
+{
+    if(m_blendEquation == blendEquation)
+        return;
+
+    m_blendEquation = blendEquation;
+    ++m_stats.stateChanges;
+}
+
+void PainterNull::setShaderProgram(PainterShaderProgram* shaderProgram)
+{
+    if(m_shaderProgram == shaderProgram)
+        return;
+
+    m_shaderProgram = shaderProgram;
+    ++m_stats.stateChanges;
+}
+
+void PainterNull::setCompositionMode(CompositionMode compositionMode)
+{
+    if(m_compositionMode == compositionMode)
+        return;
+
+    m_compositionMode = compositionMode;
+    ++m_stats.stateChanges;
+}
+
+void PainterNull::setOpacity(float opacity)
+{
+    if(m_opacity == opacity)
+        return;
+
+    m_opacity = opacity;
+    ++m_stats.stateChanges;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PAINTERNULL_H
+#define PAINTERNULL_H
+
+#define PAINTER_NULL
+
+#include <framework/graphics/painter.h>
+
+/**
+ * Painter that never touches the graphics driver, it only keeps
+ * the painter state and counts the work that would have been sent
+ * to the GPU. Intended for profiling the CPU side of rendering.
+ * It is not a headless mode: the platform window, textures,
+ * framebuffers and shaders still need a GL context, on machines
+ * without a GPU a software renderer such as Mesa llvmpipe works.
+ */
+class PainterNull : public Painter
+{
+public:
+    struct Stats {
+        uint32 drawCalls = 0;
+        uint32 vertices = 0;
+        uint32 quads = 0;
+        uint32 textureBinds = 0;
+        uint32 stateChanges = 0;
+        uint32 clears = 0;
+    };
+
+    PainterNull();
+
+    void saveState();
+    void saveAndResetState();
+    void restoreSavedState();
+
+    void clear(const Color& color) { ++m_stats.clears; }
+
+    void drawCoords(CoordsBuffer& coordsBuffer, DrawMode drawMode = Triangles);
+    void drawFillCoords(CoordsBuffer& coordsBuffer);
+    void drawTextureCoords(CoordsBuffer& coordsBuffer, const TexturePtr& texture);
+    void drawTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src);
+    void drawUpsideDownTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src);
+    void drawRepeatedTexturedRect(const Rect& dest, const TexturePtr& texture, const Rect& src);
+    void drawFilledRect(const Rect& dest);
+    void drawFilledTriangle(const Point& a, const Point& b, const Point& c);
+    void drawBoundingRect(const Rect& dest, int innerLineWidth = 1);
+
+    void setTexture(Texture* texture);
+    void setClipRect(const Rect& clipRect);
+    void setColor(const Color& color);
+    void setAlphaWriting(bool enable);
+    void setBlendEquation(BlendEquation blendEquation);
+    BlendEquation getBlendEquation() { return m_blendEquation; }
+    void setShaderProgram(PainterShaderProgram* shaderProgram);
+    void setCompositionMode(CompositionMode compositionMode);
+    void setOpacity(float opacity);
+
+    void scale(float x, float y) { }
+    void translate(float x, float y) { }
+    void rotate(float angle) { }
+    void rotate(float x, float y, float angle) { }
+
+    void pushTransformMatrix() { ++m_transformDepth; }
+    void popTransformMatrix() { assert(m_transformDepth > 0); --m_transformDepth; }
+
+    bool hasShaders() { return false; }
+
+    const Stats& getStats() { return m_stats; }
+    void resetStats() { m_stats = Stats(); }
+
+private:
+    struct PainterState {
+        Color color;
+        float opacity;
+        CompositionMode compositionMode;
+        BlendEquation blendEquation;
+        Rect clipRect;
+        Texture* texture;
+        PainterShaderProgram* shaderProgram;
+        bool alphaWriting;
+    };
+
+    void resetState();
+    void countDraw(int vertexCount, DrawMode drawMode);
+
+    BlendEquation m_blendEquation;
+    Texture* m_texture;
+    bool m_alphaWriting;
+    int m_transformDepth;
+
+    PainterState m_olderStates[10];
+    int m_oldStateIndex;
+
+    Stats m_stats;
+};
+
+extern PainterNull* g_painterNull;
+
+#endif
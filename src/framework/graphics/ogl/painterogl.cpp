@@ -65,6 +65,7 @@ void PainterOGL::saveState()
 {
     assert(m_oldStateIndex < 10);
     m_olderStates[m_oldStateIndex].resolution = m_resolution;
+    m_olderStates[m_oldStateIndex].viewportOrigin = m_viewportOrigin;
     m_olderStates[m_oldStateIndex].transformMatrix = m_transformMatrix;
     m_olderStates[m_oldStateIndex].projectionMatrix = m_projectionMatrix;
     m_olderStates[m_oldStateIndex].textureMatrix = m_textureMatrix;
@@ -88,7 +89,7 @@ void PainterOGL::saveAndResetState()
 void PainterOGL::restoreSavedState()
 {
     m_oldStateIndex--;
-    setResolution(m_olderStates[m_oldStateIndex].resolution);
+    setResolution(m_olderStates[m_oldStateIndex].resolution, m_olderStates[m_oldStateIndex].viewportOrigin);
     setTransformMatrix(m_olderStates[m_oldStateIndex].transformMatrix);
     setProjectionMatrix(m_olderStates[m_oldStateIndex].projectionMatrix);
     setTextureMatrix(m_olderStates[m_oldStateIndex].textureMatrix);
@@ -170,7 +171,7 @@ void PainterOGL::setAlphaWriting(bool enable)
     updateGlAlphaWriting();
 }
 
-void PainterOGL::setResolution(const Size& resolution)
+void PainterOGL::setResolution(const Size& resolution, const Point& origin)
 {
     // The projection matrix converts from Painter's coordinate system to GL's coordinate system
     //    * GL's viewport is 2x2, Painter's is width x height
@@ -184,16 +185,22 @@ void PainterOGL::setResolution(const Size& resolution)
     //   -------------     | 2.0 / width  |      0.0      |      0.0      |     ---------------
     //   |  x  y  1  |  *  |     0.0      | -2.0 / height |      0.0      |  =  |  x'  y'  1  |
     //   -------------     |    -1.0      |      1.0      |      1.0      |     ---------------
+    //
+    // The origin is the painter coord mapped to the top-left of the viewport, it lets
+    // a framebuffer covering only part of the screen be drawn with screen coords.
 
-    Matrix3 projectionMatrix = { 2.0f / resolution.width(),  0.0f,                      0.0f,
-                                 0.0f,                    -2.0f / resolution.height(),  0.0f,
-                                -1.0f,                     1.0f,                      1.0f };
+    Matrix3 projectionMatrix = { 2.0f / resolution.width(),                             0.0f,                                                0.0f,
+                                 0.0f,                                                -2.0f / resolution.height(),                           0.0f,
+                                -1.0f - 2.0f * origin.x / resolution.width(),          1.0f + 2.0f * origin.y / resolution.height(),       1.0f };
 
     m_resolution = resolution;
+    m_viewportOrigin = origin;
 
     setProjectionMatrix(projectionMatrix);
-    if(g_painter == this)
+    if(g_painter == this) {
         updateGlViewport();
+        updateGlClipRect();
+    }
 }
 
 void PainterOGL::scale(float x, float y)
@@ -302,7 +309,7 @@ void PainterOGL::updateGlClipRect()
 {
     if(m_clipRect.isValid()) {
         glEnable(GL_SCISSOR_TEST);
-        glScissor(m_clipRect.left(), m_resolution.height() - m_clipRect.bottom() - 1, m_clipRect.width(), m_clipRect.height());
+        glScissor(m_clipRect.left() - m_viewportOrigin.x, m_resolution.height() - (m_clipRect.bottom() - m_viewportOrigin.y) - 1, m_clipRect.width(), m_clipRect.height());
     } else {
         glScissor(0, 0, m_resolution.width(), m_resolution.height());
         glDisable(GL_SCISSOR_TEST);
@@ -30,6 +30,7 @@ class PainterOGL : public Painter
 public:
     struct PainterState {
         Size resolution;
+        Point viewportOrigin;
         Matrix3 transformMatrix;
         Matrix3 projectionMatrix;
         Matrix3 textureMatrix;
@@ -69,7 +70,7 @@ public:
     virtual void setAlphaWriting(bool enable);
 
     void setTexture(const TexturePtr& texture) { setTexture(texture.get()); }
-    void setResolution(const Size& resolution);
+    void setResolution(const Size& resolution, const Point& origin = Point());
 
     void scale(float x, float y);
     void translate(float x, float y);
@@ -82,7 +83,7 @@ public:
     Matrix3 getTransformMatrix() { return m_transformMatrix; }
     Matrix3 getProjectionMatrix() { return m_projectionMatrix; }
     Matrix3 getTextureMatrix() { return m_textureMatrix; }
-    BlendEquation getBlendEquation() { return m_blendEquation; }
+    virtual BlendEquation getBlendEquation() { return m_blendEquation; }
     PainterShaderProgram *getShaderProgram() { return m_shaderProgram; }
     bool getAlphaWriting() { return m_alphaWriting; }
 
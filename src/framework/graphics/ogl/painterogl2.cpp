@@ -43,9 +43,29 @@ PainterOGL2::PainterOGL2()
     m_drawSolidColorProgram->addShaderFromSourceCode(Shader::Fragment, glslMainFragmentShader + glslSolidColorFragmentShader);
     m_drawSolidColorProgram->link();
 
+    m_drawDistanceFieldProgram = PainterShaderProgramPtr(new PainterShaderProgram);
+    assert(m_drawDistanceFieldProgram);
+    m_drawDistanceFieldProgram->addShaderFromSourceCode(Shader::Vertex, glslMainWithTexCoordsVertexShader + glslPositionOnlyVertexShader);
+    // screen space derivatives are optional on OpenGL ES, fallback to plain texturing without them
+    if(!m_drawDistanceFieldProgram->addShaderFromSourceCode(Shader::Fragment, glslDistanceFieldExtensions + glslMainFragmentShader + glslDistanceFieldFragmentShader) ||
+       !m_drawDistanceFieldProgram->link())
+        m_drawDistanceFieldProgram = nullptr;
+
     PainterShaderProgram::release();
 }
 
+PainterShaderProgram *PainterOGL2::getTexturedProgram(const TexturePtr& texture)
+{
+    if(m_shaderProgram)
+        return m_shaderProgram;
+
+    // distance field atlases (scalable fonts) need their own program
+    if(texture && texture->isDistanceField() && m_drawDistanceFieldProgram)
+        return m_drawDistanceFieldProgram.get();
+
+    return m_drawTexturedProgram.get();
+}
+
 void PainterOGL2::bind()
 {
     PainterOGL::bind();
@@ -132,7 +152,7 @@ void PainterOGL2::drawTextureCoords(CoordsBuffer& coordsBuffer, const TexturePtr
     if(texture && texture->isEmpty())
         return;
 
-    setDrawProgram(m_shaderProgram ? m_shaderProgram : m_drawTexturedProgram.get());
+    setDrawProgram(getTexturedProgram(texture));
     setTexture(texture);
     drawCoords(coordsBuffer);
 }
@@ -142,7 +162,7 @@ void PainterOGL2::drawTexturedRect(const Rect& dest, const TexturePtr& texture,
     if(dest.isEmpty() || src.isEmpty() || texture->isEmpty())
         return;
 
-    setDrawProgram(m_shaderProgram ? m_shaderProgram : m_drawTexturedProgram.get());
+    setDrawProgram(getTexturedProgram(texture));
     setTexture(texture);
 
     m_coordsBuffer.clear();
@@ -155,7 +175,7 @@ void PainterOGL2::drawUpsideDownTexturedRect(const Rect& dest, const TexturePtr&
     if(dest.isEmpty() || src.isEmpty() || texture->isEmpty())
         return;
 
-    setDrawProgram(m_shaderProgram ? m_shaderProgram : m_drawTexturedProgram.get());
+    setDrawProgram(getTexturedProgram(texture));
     setTexture(texture);
 
     m_coordsBuffer.clear();
@@ -168,7 +188,7 @@ void PainterOGL2::drawRepeatedTexturedRect(const Rect& dest, const TexturePtr& t
     if(dest.isEmpty() || src.isEmpty() || texture->isEmpty())
         return;
 
-    setDrawProgram(m_shaderProgram ? m_shaderProgram : m_drawTexturedProgram.get());
+    setDrawProgram(getTexturedProgram(texture));
     setTexture(texture);
 
     m_coordsBuffer.clear();
@@ -55,9 +55,12 @@ public:
     bool hasShaders() { return true; }
 
 private:
+    PainterShaderProgram *getTexturedProgram(const TexturePtr& texture);
+
     PainterShaderProgram *m_drawProgram;
     PainterShaderProgramPtr m_drawTexturedProgram;
     PainterShaderProgramPtr m_drawSolidColorProgram;
+    PainterShaderProgramPtr m_drawDistanceFieldProgram;
 };
 
 extern PainterOGL2 *g_painterOGL2;
@@ -65,6 +65,26 @@ static const std::string glslTextureSrcFragmentShader = "\n\
         return texture2D(u_Tex0, v_TexCoord) * u_Color;\n\
     }\n";
 
+// the atlas alpha holds the distance to the glyph edge (0.5 on the edge),
+// the screen space derivative keeps edges one pixel wide at any scale
+#ifdef OPENGL_ES
+static const std::string glslDistanceFieldExtensions = "\n\
+    #extension GL_OES_standard_derivatives : enable\n";
+#else
+static const std::string glslDistanceFieldExtensions = "";
+#endif
+
+static const std::string glslDistanceFieldFragmentShader = "\n\
+    varying mediump vec2 v_TexCoord;\n\
+    uniform lowp vec4 u_Color;\n\
+    uniform sampler2D u_Tex0;\n\
+    lowp vec4 calculatePixel() {\n\
+        mediump float distance = texture2D(u_Tex0, v_TexCoord).a;\n\
+        mediump float width = clamp(fwidth(distance) * 0.75, 0.001, 0.5);\n\
+        lowp float alpha = smoothstep(0.5 - width, 0.5 + width, distance);\n\
+        return vec4(u_Color.rgb, u_Color.a * alpha);\n\
+    }\n";
+
 static const std::string glslSolidColorFragmentShader = "\n\
     uniform lowp vec4 u_Color;\n\
     lowp vec4 calculatePixel() {\n\
@@ -80,6 +80,7 @@ public:
     virtual void setColor(const Color& color) { m_color = color; }
     virtual void setAlphaWriting(bool enable) = 0;
     virtual void setBlendEquation(BlendEquation blendEquation) = 0;
+    virtual BlendEquation getBlendEquation() = 0;
     virtual void setShaderProgram(PainterShaderProgram* shaderProgram) { m_shaderProgram = shaderProgram; }
     void setShaderProgram(const PainterShaderProgramPtr& shaderProgram) { setShaderProgram(shaderProgram.get()); }
 
@@ -92,9 +93,10 @@ public:
     void rotate(const Point& p, float angle) { rotate(p.x, p.y, angle); }
 
     virtual void setOpacity(float opacity) { m_opacity = opacity; }
-    virtual void setResolution(const Size& resolution) { m_resolution = resolution; }
+    virtual void setResolution(const Size& resolution, const Point& origin = Point()) { m_resolution = resolution; m_viewportOrigin = origin; }
 
     Size getResolution() { return m_resolution; }
+    Point getViewportOrigin() { return m_viewportOrigin; }
     Color getColor() { return m_color; }
     float getOpacity() { return m_opacity; }
     Rect getClipRect() { return m_clipRect; }
@@ -118,6 +120,7 @@ protected:
     CompositionMode m_compositionMode;
     Color m_color;
     Size m_resolution;
+    Point m_viewportOrigin;
     float m_opacity;
     Rect m_clipRect;
 };
@@ -21,96 +21,151 @@
  */
 
 #include "particle.h"
-#include "graphics.h"
-#include <framework/core/clock.h>
+#include "particletype.h"
+#include "coordsbuffer.h"
+#include "texture.h"
 
-Particle::Particle(const Point& pos, const Size& startSize, const Size& finalSize, const PointF& velocity, const PointF& acceleration, float duration, float ignorePhysicsAfter, const std::vector<Color>& colors, const std::vector<float>& colorsStops, Painter::CompositionMode compositionMode, TexturePtr texture)
+ParticleGroup::ParticleGroup(const ParticleTypePtr& type)
 {
-    m_colors = colors;
-    m_colorsStops = colorsStops;
-
-    m_position = PointF(pos.x, pos.y);
-    m_startSize = startSize;
-    m_finalSize = finalSize;
-    m_velocity = velocity;
-    m_acceleration = acceleration;
-
-    m_compositionMode = compositionMode;
-    m_texture = texture;
-    m_duration = duration;
-    m_ignorePhysicsAfter = ignorePhysicsAfter;
-    m_elapsedTime = 0;
-    m_finished = false;
+    m_type = type;
+
+    const std::vector<Color>& colors = type->pColors;
+    const std::vector<float>& stops = type->pColorsStops;
+    for(int step = 0; step < COLOR_STEPS; ++step) {
+        const float life = step / static_cast<float>(COLOR_STEPS - 1);
+
+        // interpolate between the stops around this point of life, the last color stays
+        Color color = colors.back();
+        for(size_t i = 0; i + 1 < stops.size(); ++i) {
+            if(life >= stops[i + 1])
+                continue;
+
+            const float range = stops[i + 1] - stops[i];
+            const float factor = range > 0 ? stdext::clamp<float>((life - stops[i]) / range, 0.f, 1.f) : 1.f;
+            color = colors[i] * (1.0f - factor) + colors[i + 1] * factor;
+            break;
+        }
+        m_colors[step] = color;
+    }
 }
 
-void Particle::render()
+void ParticleGroup::add(const PointF& position, const PointF& velocity, const PointF& acceleration, float particleDuration)
 {
-    g_painter->setColor(m_color);
-
-    if(!m_texture)
-        g_painter->drawFilledRect(m_rect);
-    else {
-        g_painter->setCompositionMode(m_compositionMode);
-        g_painter->drawTexturedRect(m_rect, m_texture);
-    }
+    positionX.push_back(position.x);
+    positionY.push_back(position.y);
+    velocityX.push_back(velocity.x);
+    velocityY.push_back(velocity.y);
+    accelerationX.push_back(acceleration.x);
+    accelerationY.push_back(acceleration.y);
+    elapsed.push_back(0);
+    duration.push_back(particleDuration);
 }
 
-void Particle::update(float elapsedTime)
+void ParticleGroup::removeFinished()
 {
-    // check if finished
-    if(m_duration >= 0 && m_elapsedTime >= m_duration) {
-        m_finished = true;
-        return;
+    // compacts in place, keeping the drawing order
+    const size_t count = size();
+    size_t kept = 0;
+    for(size_t i = 0; i < count; ++i) {
+        if(duration[i] >= 0 && elapsed[i] >= duration[i])
+            continue;
+
+        if(kept != i) {
+            positionX[kept] = positionX[i];
+            positionY[kept] = positionY[i];
+            velocityX[kept] = velocityX[i];
+            velocityY[kept] = velocityY[i];
+            accelerationX[kept] = accelerationX[i];
+            accelerationY[kept] = accelerationY[i];
+            elapsed[kept] = elapsed[i];
+            duration[kept] = duration[i];
+        }
+        ++kept;
     }
 
-    updateColor();
-    updateSize();
-    updatePosition(elapsedTime);
+    if(kept == count)
+        return;
 
-    m_elapsedTime += elapsedTime;
+    positionX.resize(kept);
+    positionY.resize(kept);
+    velocityX.resize(kept);
+    velocityY.resize(kept);
+    accelerationX.resize(kept);
+    accelerationY.resize(kept);
+    elapsed.resize(kept);
+    duration.resize(kept);
 }
 
-void Particle::updatePosition(float elapsedTime)
+void ParticleGroup::update(float elapsedTime)
 {
-    if(m_ignorePhysicsAfter < 0 || m_elapsedTime < m_ignorePhysicsAfter ) {
-        // update position
-        PointF delta = m_velocity * elapsedTime;
-        delta.y *= -1; // painter orientate Y axis in the inverse direction
-
-        PointF position = m_position + delta;
-
-        if(m_position != position) {
-            m_position += delta;
-        }
-
-        // update acceleration
-        m_velocity += m_acceleration * elapsedTime;
+    const float ignorePhysicsAfter = m_type->pIgnorePhysicsAfter;
+    const size_t count = size();
+
+    float* px = positionX.data();
+    float* py = positionY.data();
+    float* vx = velocityX.data();
+    float* vy = velocityY.data();
+    const float* ax = accelerationX.data();
+    const float* ay = accelerationY.data();
+    float* life = elapsed.data();
+
+    // no branches inside, so the compiler can vectorize it
+    for(size_t i = 0; i < count; ++i) {
+        const float step = (ignorePhysicsAfter < 0 || life[i] < ignorePhysicsAfter) ? elapsedTime : 0.f;
+        px[i] += vx[i] * step;
+        py[i] -= vy[i] * step; // painter orientate Y axis in the inverse direction
+        vx[i] += ax[i] * step;
+        vy[i] += ay[i] * step;
+        life[i] += elapsedTime;
     }
-
-    m_rect.move(static_cast<int>(m_position.x) - m_size.width() / 2, static_cast<int>(m_position.y) - m_size.height() / 2);
 }
 
-void Particle::updateSize()
+void ParticleGroup::render()
 {
-    m_size = m_startSize + (m_finalSize - m_startSize) / m_duration * m_elapsedTime;
-    m_rect.resize(m_size);
-}
+    const size_t count = size();
+    if(count == 0)
+        return;
 
-void Particle::updateColor()
-{
-    float currentLife = m_elapsedTime / m_duration;
-    if(currentLife < m_colorsStops[1]) {
-        float range = m_colorsStops[1] - m_colorsStops[0];
-        float factor = (currentLife - m_colorsStops[0])/range;
-        m_color = m_colors[0] * (1.0f - factor) + m_colors[1] * factor;
-    } else {
-        if(m_colors.size() > 1) {
-            m_colors.erase(m_colors.begin());
-            m_colorsStops.erase(m_colorsStops.begin());
-        } else {
-            if(m_color != m_colors[0]) {
-                m_color = m_colors[0];
-            }
+    // particles are drawn in order, consecutive ones sharing a color step go in a single draw;
+    // they are emitted in bursts and age together, so the runs are long
+    static CoordsBuffer coordsBuffer;
+
+    const ParticleType* type = m_type.get();
+    const TexturePtr& texture = type->pTexture;
+    const Rect src = texture ? Rect(Point(0, 0), texture->getSize()) : Rect();
+    const float startWidth = type->pStartSize.width(), startHeight = type->pStartSize.height(),
+        growWidth = type->pFinalSize.width() - startWidth, growHeight = type->pFinalSize.height() - startHeight;
+
+    if(texture)
+        g_painter->setCompositionMode(type->pCompositionMode);
+
+    const auto drawRun = [&](int step) {
+        g_painter->setColor(m_colors[step]);
+        if(texture)
+            g_painter->drawTextureCoords(coordsBuffer, texture);
+        else
+            g_painter->drawFillCoords(coordsBuffer);
+        coordsBuffer.clear();
+    };
+
+    int runStep = -1;
+    for(size_t i = 0; i < count; ++i) {
+        const float life = duration[i] > 0 ? std::min<float>(elapsed[i] / duration[i], 1.f) : 0.f;
+        const int width = startWidth + growWidth * life,
+            height = startHeight + growHeight * life;
+
+        const int step = life * (COLOR_STEPS - 1) + 0.5f;
+        if(step != runStep) {
+            if(runStep >= 0)
+                drawRun(runStep);
+            runStep = step;
         }
+
+        const Rect dest(static_cast<int>(positionX[i]) - width / 2, static_cast<int>(positionY[i]) - height / 2, width, height);
+        if(texture)
+            coordsBuffer.addRect(dest, src);
+        else
+            coordsBuffer.addRect(dest);
     }
+    drawRun(runStep);
 }
@@ -26,40 +26,36 @@
 #include "declarations.h"
 #include "painter.h"
 
-class Particle : public stdext::shared_object
+// particles of one type inside a system, kept as parallel arrays so the
+// per frame loops run over contiguous floats and can be vectorized
+class ParticleGroup
 {
 public:
-    Particle(const Point& pos, const Size& startSize, const Size& finalSize, const PointF& velocity, const PointF& acceleration, float duration, float ignorePhysicsAfter, const std::vector<Color>& colors, const std::vector<float>& colorsStops, Painter::CompositionMode compositionMode = Painter::CompositionMode_Normal, TexturePtr texture = nullptr);
+    enum {
+        COLOR_STEPS = 32
+    };
+
+    ParticleGroup(const ParticleTypePtr& type);
+
+    void add(const PointF& position, const PointF& velocity, const PointF& acceleration, float duration);
+    void removeFinished();
 
     void render();
     void update(float elapsedTime);
 
-    bool hasFinished() { return m_finished; }
+    size_t size() { return positionX.size(); }
+    bool isEmpty() { return positionX.empty(); }
+    const ParticleTypePtr& getType() { return m_type; }
 
-    PointF getPosition() { return m_position; }
-    PointF getVelocity() { return m_velocity; }
-
-    void setPosition(const PointF& position) { m_position = position; }
-    void setVelocity(const PointF& velocity) { m_velocity = velocity; }
+    std::vector<float> positionX, positionY;
+    std::vector<float> velocityX, velocityY;
+    std::vector<float> accelerationX, accelerationY;
+    std::vector<float> elapsed, duration;
 
 private:
-    void updateColor();
-    void updatePosition(float elapsedTime);
-    void updateSize();
-
-    Color m_color;
-    std::vector<Color> m_colors;
-    std::vector<float> m_colorsStops;
-    TexturePtr m_texture;
-    PointF m_position;
-    PointF m_velocity;
-    PointF m_acceleration;
-    Size m_size, m_startSize, m_finalSize;
-    Rect m_rect;
-    Painter::CompositionMode m_compositionMode;
-    float m_duration, m_ignorePhysicsAfter;
-    float m_elapsedTime;
-    bool m_finished;
+    ParticleTypePtr m_type;
+    // the type colors sampled along the particle life
+    std::array<Color, COLOR_STEPS> m_colors;
 };
 
 #endif
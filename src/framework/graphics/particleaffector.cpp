@@ -87,14 +87,21 @@ void GravityAffector::load(const OTMLNodePtr& node)
     }
 }
 
-void GravityAffector::updateParticle(const ParticlePtr& particle, float elapsedTime)
+void GravityAffector::updateParticles(ParticleGroup& group, float elapsedTime)
 {
     if(!m_active)
         return;
 
-    PointF velocity = particle->getVelocity();
-    velocity += PointF(m_gravity * elapsedTime * std::cos(m_angle), m_gravity * elapsedTime * std::sin(m_angle));
-    particle->setVelocity(velocity);
+    const float deltaX = m_gravity * elapsedTime * std::cos(m_angle),
+        deltaY = m_gravity * elapsedTime * std::sin(m_angle);
+
+    float* vx = group.velocityX.data();
+    float* vy = group.velocityY.data();
+    const size_t count = group.size();
+    for(size_t i = 0; i < count; ++i) {
+        vx[i] += deltaX;
+        vy[i] += deltaY;
+    }
 }
 
 void AttractionAffector::load(const OTMLNodePtr& node)
@@ -117,20 +124,27 @@ void AttractionAffector::load(const OTMLNodePtr& node)
     }
 }
 
-void AttractionAffector::updateParticle(const ParticlePtr& particle, float elapsedTime)
+void AttractionAffector::updateParticles(ParticleGroup& group, float elapsedTime)
 {
     if(!m_active)
         return;
 
-    PointF pPosition = particle->getPosition();
-    PointF d = PointF(m_position.x - pPosition.x, pPosition.y - m_position.y);
-    if(d.length() == 0)
-        return;
-
-    PointF direction = PointF(1, 1);
-    if(m_repelish)
-        direction = PointF(-1, -1);
-
-    PointF pVelocity = particle->getVelocity() + (d / d.length() * m_acceleration * elapsedTime) * direction;
-    particle->setVelocity(pVelocity - pVelocity * m_reduction/100.0 * elapsedTime);
+    const float pull = m_acceleration * elapsedTime * (m_repelish ? -1 : 1),
+        keep = 1.0f - m_reduction / 100.0f * elapsedTime;
+
+    const float* px = group.positionX.data();
+    const float* py = group.positionY.data();
+    float* vx = group.velocityX.data();
+    float* vy = group.velocityY.data();
+    const size_t count = group.size();
+    for(size_t i = 0; i < count; ++i) {
+        const float dx = m_position.x - px[i],
+            dy = py[i] - m_position.y,
+            length = std::sqrt(dx * dx + dy * dy);
+        if(length == 0)
+            continue;
+
+        vx[i] = (vx[i] + dx / length * pull) * keep;
+        vy[i] = (vy[i] + dy / length * pull) * keep;
+    }
 }
@@ -79,13 +79,18 @@ void ParticleEmitter::update(float elapsedTime, const ParticleSystemPtr& system)
         return;
 
     int nextBurst = std::floor((m_elapsedTime - m_delay) * m_burstRate) + 1;
+    if(nextBurst <= m_currentBurst)
+        return;
+
     const ParticleType *type = m_particleType.get();
+    ParticleGroup& group = system->getGroup(m_particleType);
     for(int b = m_currentBurst; b < nextBurst; ++b) {
         // every burst created at same position.
         float pRadius = stdext::random_range(type->pMinPositionRadius, type->pMaxPositionRadius);
         float pAngle = stdext::random_range(type->pMinPositionAngle, type->pMaxPositionAngle);
 
         Point pPosition = m_position + Point(pRadius * std::cos(pAngle), pRadius * std::sin(pAngle));
+        const PointF position(pPosition.x, pPosition.y);
 
         for(int p = 0; p < m_burstCount; ++p) {
             float pDuration = stdext::random_range(type->pMinDuration, type->pMaxDuration);
@@ -100,12 +105,7 @@ void ParticleEmitter::update(float elapsedTime, const ParticleSystemPtr& system)
             float pAccelerationAngle = stdext::random_range(type->pMinAccelerationAngle, type->pMaxAccelerationAngle);
             PointF pAcceleration(pAccelerationAbs * std::cos(pAccelerationAngle), pAccelerationAbs * std::sin(pAccelerationAngle));
 
-            ParticlePtr particle(new Particle(pPosition, type->pStartSize, type->pFinalSize,
-                                                pVelocity, pAcceleration,
-                                                pDuration, type->pIgnorePhysicsAfter,
-                                                type->pColors, type->pColorsStops,
-                                                type->pCompositionMode, type->pTexture));
-            system->addParticle(particle);
+            group.add(position, pVelocity, pAcceleration, pDuration);
         }
     }
 
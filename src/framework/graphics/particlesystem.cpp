@@ -54,15 +54,21 @@ void ParticleSystem::load(const OTMLNodePtr& node)
     }
 }
 
-void ParticleSystem::addParticle(const ParticlePtr& particle)
+ParticleGroup& ParticleSystem::getGroup(const ParticleTypePtr& type)
 {
-    m_particles.push_back(particle);
+    for(ParticleGroup& group : m_groups) {
+        if(group.getType() == type)
+            return group;
+    }
+
+    m_groups.emplace_back(type);
+    return m_groups.back();
 }
 
 void ParticleSystem::render()
 {
-    for(auto &particle: m_particles)
-        particle->render();
+    for(ParticleGroup& group : m_groups)
+        group.render();
     g_painter->resetCompositionMode();
 }
 
@@ -76,7 +82,8 @@ void ParticleSystem::update()
         return;
 
     // check if finished
-    if(m_particles.empty() && m_emitters.empty()) {
+    const bool hasParticles = std::any_of(m_groups.begin(), m_groups.end(), [](ParticleGroup& group) { return !group.isEmpty(); });
+    if(!hasParticles && m_emitters.empty()) {
         m_finished = true;
         return;
     }
@@ -108,19 +115,14 @@ void ParticleSystem::update()
             }
         }
 
-        // update particles
-        for(auto it = m_particles.begin(); it != m_particles.end();) {
-            const ParticlePtr& particle = *it;
-            if(particle->hasFinished()) {
-                it = m_particles.erase(it);
-            } else {
-                // pass particles through affectors
-                for(const ParticleAffectorPtr& particleAffector : m_affectors)
-                    particleAffector->updateParticle(particle, delay);
+        // update particles, each affector runs over a whole group at once
+        for(ParticleGroup& group : m_groups) {
+            group.removeFinished();
 
-                particle->update(delay);
-                ++it;
-            }
+            for(const ParticleAffectorPtr& particleAffector : m_affectors)
+                particleAffector->updateParticles(group, delay);
+
+            group.update(delay);
         }
     }
 }
@@ -34,7 +34,7 @@ public:
 
     void load(const OTMLNodePtr& node);
 
-    void addParticle(const ParticlePtr& particle);
+    ParticleGroup& getGroup(const ParticleTypePtr& type);
 
     void render();
     void update();
@@ -44,7 +44,8 @@ public:
 private:
     bool m_finished;
     float m_lastUpdateTime;
-    std::list<ParticlePtr> m_particles;
+    // a deque keeps groups in place while emitters add new ones
+    std::deque<ParticleGroup> m_groups;
     std::list<ParticleEmitterPtr> m_emitters;
     std::list<ParticleAffectorPtr> m_affectors;
 };
@@ -43,6 +43,7 @@ ParticleType::ParticleType()
     pMaxAcceleration = 64;
     pMinAccelerationAngle = 0;
     pMaxAccelerationAngle = 360;
+    pCompositionMode = Painter::CompositionMode_Normal;
 }
 
 void ParticleType::load(const OTMLNodePtr& node)
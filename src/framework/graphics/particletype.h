@@ -67,6 +67,7 @@ protected:
     Painter::CompositionMode pCompositionMode;
 
     friend class ParticleEmitter;
+    friend class ParticleGroup;
 };
 
 #endif
@@ -66,8 +66,26 @@ bool Shader::compileSourceCode(const std::string& sourceCode)
         "precision highp float;\n";
 #endif
 
-    std::string code = qualifierDefines;
+    std::string code;
+#ifdef OPENGL_ES
+    // extension directives must come before any other statement
+    std::string body;
+    for(std::string line : stdext::split(sourceCode, "\n")) {
+        stdext::trim(line);
+        if(stdext::starts_with(line, "#extension")) {
+            code.append(line);
+            code.append("\n");
+        } else {
+            body.append(line);
+            body.append("\n");
+        }
+    }
+    code.append(qualifierDefines);
+    code.append(body);
+#else
+    code = qualifierDefines;
     code.append(sourceCode);
+#endif
     const char *c_source = code.c_str();
     glShaderSource(m_shaderId, 1, &c_source, nullptr);
     glCompileShader(m_shaderId);
@@ -99,6 +99,16 @@ void Texture::uploadPixels(const ImagePtr& image, bool buildMipmaps, bool compre
     m_opaque = !image->hasTransparentPixel();
 }
 
+// pixels must be tightly packed RGBA rows of the rect width
+void Texture::uploadSubPixels(const Rect& rect, const uint8* pixels)
+{
+    if (m_id == 0 || !rect.isValid())
+        return;
+
+    bind();
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.left(), rect.top(), rect.width(), rect.height(), GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
 void Texture::bind()
 {
     // must reset painter texture state
@@ -128,6 +138,18 @@ bool Texture::buildHardwareMipmaps()
     return true;
 }
 
+// limits the mipmap levels that are built and sampled, not available on OpenGL ES
+bool Texture::setMaxMipmapLevel(int level)
+{
+#ifdef OPENGL_ES
+    return false;
+#else
+    bind();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level);
+    return true;
+#endif
+}
+
 void Texture::setSmooth(bool smooth)
 {
     if (smooth && !g_graphics.canUseBilinearFiltering())
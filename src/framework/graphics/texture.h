@@ -34,13 +34,16 @@ public:
     virtual ~Texture();
 
     void uploadPixels(const ImagePtr& image, bool buildMipmaps = false, bool compress = false);
+    void uploadSubPixels(const Rect& rect, const uint8* pixels);
     void bind();
     void copyFromScreen(const Rect& screenRect);
     virtual bool buildHardwareMipmaps();
+    bool setMaxMipmapLevel(int level);
 
     virtual void setSmooth(bool smooth);
     virtual void setRepeat(bool repeat);
     void setUpsideDown(bool upsideDown);
+    void setDistanceField(bool distanceField) { m_distanceField = distanceField; }
     void setTime(ticks_t time) { m_time = time; }
 
     uint getId() { return m_id; }
@@ -55,6 +58,7 @@ public:
     bool hasMipmaps() { return m_hasMipmaps; }
     virtual bool isAnimatedTexture() { return false; }
     bool isOpaque() const { return m_opaque; }
+    bool isDistanceField() { return m_distanceField; }
 
 protected:
     void createTexture();
@@ -74,6 +78,7 @@ protected:
     stdext::boolean<false> m_upsideDown;
     stdext::boolean<false> m_repeat;
     stdext::boolean<false> m_opaque;
+    stdext::boolean<false> m_distanceField;
 };
 
 #endif
@@ -55,6 +55,7 @@
 #include <framework/net/server.h>
 #include <framework/net/protocol.h>
 #include <framework/net/protocolhttp.h>
+#include <framework/net/packetplayer.h>
 #endif
 
 #ifdef FW_SQL
@@ -118,6 +119,10 @@ void Application::registerLuaFunctions()
     g_lua.bindSingletonFunction("g_crypt", "genUUID", &Crypt::genUUID, &g_crypt);
     g_lua.bindSingletonFunction("g_crypt", "setMachineUUID", &Crypt::setMachineUUID, &g_crypt);
     g_lua.bindSingletonFunction("g_crypt", "getMachineUUID", &Crypt::getMachineUUID, &g_crypt);
+    g_lua.bindClassStaticFunction("g_crypt", "xteaSelfTest", &stdext::xtea_self_test);
+    g_lua.bindClassStaticFunction("g_crypt", "xteaBenchmark", &stdext::xtea_benchmark);
+    g_lua.bindClassStaticFunction("g_crypt", "adler32SelfTest", &stdext::adler32_self_test);
+    g_lua.bindClassStaticFunction("g_crypt", "adler32Benchmark", &stdext::adler32_benchmark);
     g_lua.bindSingletonFunction("g_crypt", "encrypt", &Crypt::encrypt, &g_crypt);
     g_lua.bindSingletonFunction("g_crypt", "decrypt", &Crypt::decrypt, &g_crypt);
     g_lua.bindSingletonFunction("g_crypt", "rsaSetPublicKey", &Crypt::rsaSetPublicKey, &g_crypt);
@@ -406,6 +411,8 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIWidget>("setAutoFocusPolicy", &UIWidget::setAutoFocusPolicy);
     g_lua.bindClassMemberFunction<UIWidget>("setAutoRepeatDelay", &UIWidget::setAutoRepeatDelay);
     g_lua.bindClassMemberFunction<UIWidget>("setVirtualOffset", &UIWidget::setVirtualOffset);
+    g_lua.bindClassMemberFunction<UIWidget>("setRenderCache", &UIWidget::setRenderCache);
+    g_lua.bindClassMemberFunction<UIWidget>("invalidateRenderCache", &UIWidget::invalidateRenderCache);
     g_lua.bindClassMemberFunction<UIWidget>("isVisible", &UIWidget::isVisible);
     g_lua.bindClassMemberFunction<UIWidget>("isChildLocked", &UIWidget::isChildLocked);
     g_lua.bindClassMemberFunction<UIWidget>("hasChild", &UIWidget::hasChild);
@@ -454,6 +461,7 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<UIWidget>("isDraggable", &UIWidget::isDraggable);
     g_lua.bindClassMemberFunction<UIWidget>("isFixedSize", &UIWidget::isFixedSize);
     g_lua.bindClassMemberFunction<UIWidget>("isClipping", &UIWidget::isClipping);
+    g_lua.bindClassMemberFunction<UIWidget>("isRenderCached", &UIWidget::isRenderCached);
     g_lua.bindClassMemberFunction<UIWidget>("isDestroyed", &UIWidget::isDestroyed);
     g_lua.bindClassMemberFunction<UIWidget>("hasChildren", &UIWidget::hasChildren);
     g_lua.bindClassMemberFunction<UIWidget>("containsMarginPoint", &UIWidget::containsMarginPoint);
@@ -760,6 +768,24 @@ void Application::registerLuaFunctions()
     // Connection
     g_lua.registerClass<Connection>();
     g_lua.bindClassMemberFunction<Connection>("getIp", &Connection::getIp);
+    g_lua.bindClassMemberFunction<Connection>("setWriteDelay", &Connection::setWriteDelay);
+    g_lua.bindClassMemberFunction<Connection>("setNoDelay", &Connection::setNoDelay);
+    g_lua.bindClassMemberFunction<Connection>("setKeepAlive", &Connection::setKeepAlive);
+    g_lua.bindClassMemberFunction<Connection>("setSendBufferSize", &Connection::setSendBufferSize);
+    g_lua.bindClassMemberFunction<Connection>("setRecvBufferSize", &Connection::setRecvBufferSize);
+    g_lua.bindClassMemberFunction<Connection>("getWriteDelay", &Connection::getWriteDelay);
+    g_lua.bindClassMemberFunction<Connection>("isNoDelay", &Connection::isNoDelay);
+    g_lua.bindClassMemberFunction<Connection>("isKeepAlive", &Connection::isKeepAlive);
+    g_lua.bindClassMemberFunction<Connection>("getSendBufferSize", &Connection::getSendBufferSize);
+    g_lua.bindClassMemberFunction<Connection>("getRecvBufferSize", &Connection::getRecvBufferSize);
+    g_lua.bindClassMemberFunction<Connection>("getBytesSent", &Connection::getBytesSent);
+    g_lua.bindClassMemberFunction<Connection>("getBytesReceived", &Connection::getBytesReceived);
+    g_lua.bindClassMemberFunction<Connection>("getPacketsSent", &Connection::getPacketsSent);
+    g_lua.bindClassMemberFunction<Connection>("getPacketsReceived", &Connection::getPacketsReceived);
+    g_lua.bindClassMemberFunction<Connection>("getWriteCount", &Connection::getWriteCount);
+    g_lua.bindClassMemberFunction<Connection>("getRtt", &Connection::getRtt);
+    g_lua.bindClassMemberFunction<Connection>("getRttVariance", &Connection::getRttVariance);
+    g_lua.bindClassMemberFunction<Connection>("resetStats", &Connection::resetStats);
 
     // Protocol
     g_lua.registerClass<Protocol>();
@@ -777,6 +803,21 @@ void Application::registerLuaFunctions()
     g_lua.bindClassMemberFunction<Protocol>("generateXteaKey", &Protocol::generateXteaKey);
     g_lua.bindClassMemberFunction<Protocol>("enableXteaEncryption", &Protocol::enableXteaEncryption);
     g_lua.bindClassMemberFunction<Protocol>("enableChecksum", &Protocol::enableChecksum);
+    g_lua.bindClassMemberFunction<Protocol>("enableCompression", &Protocol::enableCompression);
+    g_lua.bindClassMemberFunction<Protocol>("enableOutputCompression", &Protocol::enableOutputCompression);
+
+    // PacketPlayer
+    g_lua.registerClass<PacketPlayer>();
+    g_lua.bindClassStaticFunction<PacketPlayer>("create", [](const std::string& fileName) { return PacketPlayerPtr(new PacketPlayer(fileName)); });
+    g_lua.bindClassMemberFunction<PacketPlayer>("getProtocolVersion", &PacketPlayer::getProtocolVersion);
+    g_lua.bindClassMemberFunction<PacketPlayer>("getClientVersion", &PacketPlayer::getClientVersion);
+    g_lua.bindClassMemberFunction<PacketPlayer>("getCharacterName", &PacketPlayer::getCharacterName);
+    g_lua.bindClassMemberFunction<PacketPlayer>("getWorldName", &PacketPlayer::getWorldName);
+    g_lua.bindClassMemberFunction<PacketPlayer>("getFileName", &PacketPlayer::getFileName);
+    g_lua.bindClassMemberFunction<PacketPlayer>("getPacketCount", &PacketPlayer::getPacketCount);
+    g_lua.bindClassMemberFunction<PacketPlayer>("getDuration", &PacketPlayer::getDuration);
+    g_lua.bindClassMemberFunction<PacketPlayer>("getPacketTime", &PacketPlayer::getPacketTime);
+    g_lua.bindClassMemberFunction<PacketPlayer>("getPacket", &PacketPlayer::getPacket);
 
     // ProtocolHttp
     g_lua.registerClass<ProtocolHttp>();
@@ -21,15 +21,25 @@
  */
 
 #include "connection.h"
+#include "inputmessage.h"
+#include "messagebuffer.h"
 
 #include <framework/core/application.h>
 #include <framework/core/eventdispatcher.h>
+#include <framework/stdext/xtea.h>
 
 #include <boost/asio.hpp>
 #include <memory>
 
 asio::io_service g_ioService;
-std::list<std::shared_ptr<asio::streambuf>> Connection::m_outputStreams;
+std::list<Connection::OutputQueuePtr> Connection::m_outputQueues;
+
+std::thread Connection::m_networkThread;
+std::unique_ptr<asio::io_service::work> Connection::m_networkWork;
+std::unique_ptr<stdext::spsc_queue<Connection::NetworkEvent>> Connection::m_networkEvents;
+std::atomic<bool> Connection::m_networkThreadRunning(false);
+
+static thread_local bool t_networkThread = false;
 
 Connection::Connection() :
     m_readTimer(g_ioService),
@@ -40,6 +50,13 @@ Connection::Connection() :
 {
     m_connected = false;
     m_connecting = false;
+    m_readingMessages = false;
+    m_writing = false;
+    m_flushPending = false;
+    m_writeDelay = 0;
+    m_rtt = -1;
+    m_rttVariance = 0;
+    resetStats();
 }
 
 Connection::~Connection()
@@ -47,11 +64,17 @@ Connection::~Connection()
 #ifndef NDEBUG
     assert(!g_app.isTerminated());
 #endif
-    close();
+    // nothing else references this connection anymore, so no thread is using it
+    internal_close();
 }
 
 void Connection::poll()
 {
+    if (m_networkThreadRunning) {
+        pollNetworkEvents();
+        return;
+    }
+
     // reset must always be called prior to poll
     g_ioService.reset();
     g_ioService.poll();
@@ -59,8 +82,145 @@ void Connection::poll()
 
 void Connection::terminate()
 {
-    g_ioService.stop();
-    m_outputStreams.clear();
+    if (m_networkThreadRunning) {
+        m_networkThreadRunning = false;
+        m_networkWork.reset();
+        g_ioService.stop();
+        m_networkThread.join();
+
+        // drop what the main thread never got to handle
+        while (NetworkEvent* event = m_networkEvents->front()) {
+            event->connection = nullptr;
+            event->buffer = nullptr;
+            m_networkEvents->pop();
+        }
+        MessageBuffer::setThreadSafe(false);
+    }
+    else
+        g_ioService.stop();
+
+    m_outputQueues.clear();
+    MessageBuffer::clearPool();
+}
+
+void Connection::startNetworkThread()
+{
+#ifdef THREAD_SAFE
+    if (m_networkThreadRunning)
+        return;
+
+    m_networkEvents.reset(new stdext::spsc_queue<NetworkEvent>(NETWORK_EVENTS_CAPACITY));
+    m_networkWork.reset(new asio::io_service::work(g_ioService));
+    m_networkThreadRunning = true;
+    MessageBuffer::setThreadSafe(true);
+
+    g_ioService.reset();
+    m_networkThread = std::thread([] {
+        t_networkThread = true;
+        g_ioService.run();
+    });
+#else
+    // connections and message buffers are shared between threads, that needs atomic reference counting
+    g_logger.error("the network thread requires a build with FRAMEWORK_THREAD_SAFE enabled");
+#endif
+}
+
+bool Connection::isNetworkThread()
+{
+    return t_networkThread;
+}
+
+void Connection::pollNetworkEvents()
+{
+    while (NetworkEvent* event = m_networkEvents->front()) {
+        ConnectionPtr connection = event->connection;
+        event->connection = nullptr;
+        connection->handleNetworkEvent(*event);
+        event->buffer = nullptr;
+        m_networkEvents->pop();
+    }
+}
+
+void Connection::pushNetworkEvent(NetworkEvent::Type type, const boost::system::error_code& error, const uint8* data, size_t size)
+{
+    if (!isNetworkThread()) {
+        NetworkEvent event;
+        event.type = type;
+        event.error = error;
+        event.data.assign(data, data + size);
+        handleNetworkEvent(event);
+        return;
+    }
+
+    NetworkEvent* event;
+    while (!(event = m_networkEvents->back())) {
+        // the main thread is behind, wait for it instead of dropping messages
+        if (!m_networkThreadRunning)
+            return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    event->connection = asConnection();
+    event->type = type;
+    event->error = error;
+    event->data.assign(data, data + size);
+    event->buffer = nullptr;
+    m_networkEvents->push();
+}
+
+void Connection::pushReceivedBuffer(const MessageBufferPtr& buffer, uint32 size)
+{
+    if (!isNetworkThread()) {
+        NetworkEvent event;
+        event.type = NetworkEvent::Received;
+        event.buffer = buffer;
+        event.bufferSize = size;
+        handleNetworkEvent(event);
+        return;
+    }
+
+    NetworkEvent* event;
+    while (!(event = m_networkEvents->back())) {
+        if (!m_networkThreadRunning)
+            return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    event->connection = asConnection();
+    event->type = NetworkEvent::Received;
+    event->error = boost::system::error_code();
+    event->data.clear();
+    event->buffer = buffer;
+    event->bufferSize = size;
+    m_networkEvents->push();
+}
+
+void Connection::handleNetworkEvent(NetworkEvent& event)
+{
+    switch (event.type) {
+    case NetworkEvent::Connected:
+        m_activityTimer.restart();
+        if (m_connectCallback)
+            m_connectCallback();
+        break;
+    case NetworkEvent::Received:
+        m_activityTimer.restart();
+        if (!m_recvCallback)
+            break;
+        if (event.buffer)
+            m_recvCallback(event.buffer->data(), event.bufferSize);
+        else
+            m_recvCallback(event.data.data(), event.data.size());
+        break;
+    case NetworkEvent::InvalidMessage:
+        g_logger.traceError(std::string(event.data.begin(), event.data.end()));
+        break;
+    case NetworkEvent::Error:
+        m_error = event.error;
+        if (m_errorCallback)
+            m_errorCallback(event.error);
+        break;
+    }
 }
 
 void Connection::close()
@@ -68,15 +228,36 @@ void Connection::close()
     if (!m_connected && !m_connecting)
         return;
 
-    // flush send data before disconnecting on clean connections
-    if (m_connected && !m_error && m_outputStream)
-        internal_write();
+    if (m_networkThreadRunning && !isNetworkThread()) {
+        // callbacks belong to the main thread, the socket to the network thread
+        m_connectCallback = nullptr;
+        m_errorCallback = nullptr;
+        m_recvCallback = nullptr;
+        g_ioService.post(std::bind(&Connection::internal_close, asConnection()));
+        return;
+    }
 
-    m_connecting = false;
-    m_connected = false;
     m_connectCallback = nullptr;
     m_errorCallback = nullptr;
     m_recvCallback = nullptr;
+    internal_close();
+}
+
+void Connection::internal_close()
+{
+    if (!m_connected && !m_connecting)
+        return;
+
+    // flush send data before disconnecting on clean connections,
+    // the network thread drops its queue on errors since m_error belongs to the main thread
+    if (m_connected && m_outputQueue && (isNetworkThread() || !m_error))
+        internal_write(true);
+
+    m_connecting = false;
+    m_connected = false;
+    m_readingMessages = false;
+    m_writing = false;
+    m_flushPending = false;
 
     m_resolver.cancel();
     m_readTimer.cancel();
@@ -96,7 +277,18 @@ void Connection::connect(const std::string& host, uint16 port, const std::functi
     m_connecting = true;
     m_error.clear();
     m_connectCallback = connectCallback;
+    resetStats();
 
+    if (m_networkThreadRunning && !isNetworkThread()) {
+        g_ioService.post(std::bind(&Connection::internal_resolve, asConnection(), host, port));
+        return;
+    }
+
+    internal_resolve(host, port);
+}
+
+void Connection::internal_resolve(const std::string& host, uint16 port)
+{
     asio::ip::tcp::resolver::query query(host, stdext::unsafe_cast<std::string>(port));
     m_resolver.async_resolve(query, std::bind(&Connection::onResolve, asConnection(), std::placeholders::_1, std::placeholders::_2));
 
@@ -119,36 +311,76 @@ void Connection::write(uint8* buffer, size_t size)
     if (!m_connected)
         return;
 
-    // we can't send the data right away, otherwise we could create tcp congestion
-    if (!m_outputStream) {
-        if (!m_outputStreams.empty()) {
-            m_outputStream = m_outputStreams.front();
-            m_outputStreams.pop_front();
+    // raw data has no buffer to keep alive, so it's copied into message buffers
+    while (size > 0) {
+        size_t chunkSize = std::min<size_t>(size, MessageBuffer::MAX_CAPACITY);
+        MessageBufferPtr chunk = MessageBuffer::create(chunkSize);
+        memcpy(chunk->data(), buffer, chunkSize);
+        write(chunk, chunk->data(), chunkSize);
+        buffer += chunkSize;
+        size -= chunkSize;
+    }
+}
+
+void Connection::write(const MessageBufferPtr& buffer, uint8* data, size_t size, bool immediate)
+{
+    if (!m_connected)
+        return;
+
+    if (m_networkThreadRunning && !isNetworkThread()) {
+        void (Connection::*bufferWrite)(const MessageBufferPtr&, uint8*, size_t, bool) = &Connection::write;
+        g_ioService.post(std::bind(bufferWrite, asConnection(), buffer, data, size, immediate));
+        return;
+    }
+
+    // we can't send the data right away, otherwise we could create tcp congestion,
+    // writes made within the write delay are coalesced into a single gathered write
+    if (!m_outputQueue) {
+        if (!m_outputQueues.empty()) {
+            m_outputQueue = m_outputQueues.front();
+            m_outputQueues.pop_front();
         }
         else
-            m_outputStream = std::make_shared<asio::streambuf>();
+            m_outputQueue = std::make_shared<OutputQueue>();
 
-        m_delayedWriteTimer.cancel();
-        m_delayedWriteTimer.expires_from_now(boost::posix_time::milliseconds(0));
-        m_delayedWriteTimer.async_wait(std::bind(&Connection::onCanWrite, asConnection(), std::placeholders::_1));
+        if (!immediate) {
+            m_delayedWriteTimer.cancel();
+            m_delayedWriteTimer.expires_from_now(boost::posix_time::microseconds(m_writeDelay.load()));
+            m_delayedWriteTimer.async_wait(std::bind(&Connection::onCanWrite, asConnection(), std::placeholders::_1));
+        }
     }
 
-    std::ostream os(m_outputStream.get());
-    os.write((const char*)buffer, size);
-    os.flush();
+    // the buffer is referenced until the write completes, its bytes are never copied
+    m_outputQueue->buffers.push_back(buffer);
+    m_outputQueue->sequence.push_back(asio::const_buffer(data, size));
+    ++m_packetsSent;
+
+    // urgent messages take everything queued so far along without waiting for the delay
+    if (immediate) {
+        m_delayedWriteTimer.cancel();
+        internal_write();
+    }
 }
 
-void Connection::internal_write()
+void Connection::internal_write(bool force)
 {
-    if (!m_connected)
+    if (!m_connected || !m_outputQueue)
+        return;
+
+    // only one write is in flight at a time, what was queued meanwhile is sent when it completes
+    if (m_writing && !force) {
+        m_flushPending = true;
         return;
+    }
 
-    std::shared_ptr<asio::streambuf> outputStream = m_outputStream;
-    m_outputStream = nullptr;
+    OutputQueuePtr outputQueue = m_outputQueue;
+    m_outputQueue = nullptr;
+    m_writing = true;
+    m_flushPending = false;
 
     asio::async_write(m_socket,
-        *outputStream,
-        std::bind(&Connection::onWrite, asConnection(), std::placeholders::_1, std::placeholders::_2, outputStream));
+        outputQueue->sequence,
+        std::bind(&Connection::onWrite, asConnection(), std::placeholders::_1, std::placeholders::_2, outputQueue));
 
     m_writeTimer.cancel();
     m_writeTimer.expires_from_now(boost::posix_time::seconds(static_cast<uint32>(WRITE_TIMEOUT)));
@@ -162,6 +394,14 @@ void Connection::read(uint16 bytes, const RecvCallback& callback)
 
     m_recvCallback = callback;
 
+    if (m_networkThreadRunning && !isNetworkThread())
+        g_ioService.post(std::bind(&Connection::internal_read, asConnection(), bytes));
+    else
+        internal_read(bytes);
+}
+
+void Connection::internal_read(uint16 bytes)
+{
     asio::async_read(m_socket,
         asio::buffer(m_inputStream.prepare(bytes)),
         std::bind(&Connection::onRecv, asConnection(), std::placeholders::_1, std::placeholders::_2));
@@ -178,6 +418,14 @@ void Connection::read_until(const std::string& what, const RecvCallback& callbac
 
     m_recvCallback = callback;
 
+    if (m_networkThreadRunning && !isNetworkThread())
+        g_ioService.post(std::bind(&Connection::internal_read_until, asConnection(), what));
+    else
+        internal_read_until(what);
+}
+
+void Connection::internal_read_until(const std::string& what)
+{
     asio::async_read_until(m_socket,
         m_inputStream,
         what,
@@ -195,6 +443,14 @@ void Connection::read_some(const RecvCallback& callback)
 
     m_recvCallback = callback;
 
+    if (m_networkThreadRunning && !isNetworkThread())
+        g_ioService.post(std::bind(&Connection::internal_read_some, asConnection()));
+    else
+        internal_read_some();
+}
+
+void Connection::internal_read_some()
+{
     m_socket.async_read_some(asio::buffer(m_inputStream.prepare(RECV_BUFFER_SIZE)),
         std::bind(&Connection::onRecv, asConnection(), std::placeholders::_1, std::placeholders::_2));
 
@@ -203,6 +459,43 @@ void Connection::read_some(const RecvCallback& callback)
     m_readTimer.async_wait(std::bind(&Connection::onTimeout, asConnection(), std::placeholders::_1));
 }
 
+void Connection::readMessages(const MessageFraming& framing, const RecvCallback& callback)
+{
+    if (!m_connected)
+        return;
+
+    m_recvCallback = callback;
+    g_ioService.post(std::bind(&Connection::internal_readMessages, asConnection(), framing));
+}
+
+void Connection::setMessageFraming(const MessageFraming& framing)
+{
+    // posted like writes, so it applies to everything the server answers after them
+    g_ioService.post(std::bind(&Connection::internal_setMessageFraming, asConnection(), framing));
+}
+
+void Connection::internal_readMessages(const MessageFraming& framing)
+{
+    m_framing = framing;
+    if (m_readingMessages || !m_connected)
+        return;
+
+    m_readingMessages = true;
+    internal_readMessageHeader();
+}
+
+void Connection::internal_readMessageHeader()
+{
+    m_messageBuffer.resize(2);
+    asio::async_read(m_socket,
+        asio::buffer(m_messageBuffer),
+        std::bind(&Connection::onRecvMessageHeader, asConnection(), std::placeholders::_1, std::placeholders::_2));
+
+    m_readTimer.cancel();
+    m_readTimer.expires_from_now(boost::posix_time::seconds(static_cast<uint32>(READ_TIMEOUT)));
+    m_readTimer.async_wait(std::bind(&Connection::onTimeout, asConnection(), std::placeholders::_1));
+}
+
 void Connection::onResolve(const boost::system::error_code& error, asio::ip::basic_resolver<asio::ip::tcp>::iterator endpointIterator)
 {
     m_readTimer.cancel();
@@ -219,7 +512,8 @@ void Connection::onResolve(const boost::system::error_code& error, asio::ip::bas
 void Connection::onConnect(const boost::system::error_code& error)
 {
     m_readTimer.cancel();
-    m_activityTimer.restart();
+    if (!isNetworkThread())
+        m_activityTimer.restart();
 
     if (error == asio::error::operation_aborted)
         return;
@@ -227,9 +521,14 @@ void Connection::onConnect(const boost::system::error_code& error)
     if (!error) {
         m_connected = true;
 
-        // disable nagle's algorithm, this make the game play smoother
-        boost::asio::ip::tcp::no_delay option(true);
-        m_socket.set_option(option);
+        // nagle's algorithm is disabled by default, this make the game play smoother
+        applySocketOptions();
+
+        if (isNetworkThread()) {
+            m_connecting = false;
+            pushNetworkEvent(NetworkEvent::Connected);
+            return;
+        }
 
         if (m_connectCallback)
             m_connectCallback();
@@ -251,35 +550,126 @@ void Connection::onCanWrite(const boost::system::error_code& error)
         internal_write();
 }
 
-void Connection::onWrite(const boost::system::error_code& error, size_t, std::shared_ptr<asio::streambuf> outputStream)
+void Connection::onWrite(const boost::system::error_code& error, size_t writeSize, OutputQueuePtr outputQueue)
 {
     m_writeTimer.cancel();
+    m_writing = false;
 
     if (error == asio::error::operation_aborted)
         return;
 
-    // free output stream and store for using it again later
-    outputStream->consume(outputStream->size());
-    m_outputStreams.push_back(outputStream);
+    if (!error) {
+        m_bytesSent += writeSize;
+        ++m_writeCount;
+    }
+
+    // release the sent buffers and store the queue for using it again later
+    outputQueue->buffers.clear();
+    outputQueue->sequence.clear();
+    m_outputQueues.push_back(outputQueue);
 
     if (m_connected && error)
         handleError(error);
+    else if (m_flushPending)
+        internal_write();
+}
+
+void Connection::setNoDelay(bool enable)
+{
+    SocketOptions options = m_socketOptions;
+    options.noDelay = enable;
+    internal_setSocketOptions(options);
+}
+
+void Connection::setKeepAlive(bool enable)
+{
+    SocketOptions options = m_socketOptions;
+    options.keepAlive = enable;
+    internal_setSocketOptions(options);
+}
+
+void Connection::setSendBufferSize(int size)
+{
+    SocketOptions options = m_socketOptions;
+    options.sendBufferSize = std::max<int>(size, 0);
+    internal_setSocketOptions(options);
+}
+
+void Connection::setRecvBufferSize(int size)
+{
+    SocketOptions options = m_socketOptions;
+    options.recvBufferSize = std::max<int>(size, 0);
+    internal_setSocketOptions(options);
+}
+
+void Connection::internal_setSocketOptions(const SocketOptions& options)
+{
+    if (m_networkThreadRunning && !isNetworkThread()) {
+        // the main thread keeps its own copy for the getters
+        m_socketOptions = options;
+        g_ioService.post(std::bind(&Connection::internal_setSocketOptions, asConnection(), options));
+        return;
+    }
+
+    if (!isNetworkThread())
+        m_socketOptions = options;
+    m_activeSocketOptions = options;
+    if (m_connected)
+        applySocketOptions();
+}
+
+void Connection::applySocketOptions()
+{
+    // failures are ignored, the system defaults are still usable
+    boost::system::error_code ec;
+    m_socket.set_option(asio::ip::tcp::no_delay(m_activeSocketOptions.noDelay), ec);
+    m_socket.set_option(asio::socket_base::keep_alive(m_activeSocketOptions.keepAlive), ec);
+    if (m_activeSocketOptions.sendBufferSize > 0)
+        m_socket.set_option(asio::socket_base::send_buffer_size(m_activeSocketOptions.sendBufferSize), ec);
+    if (m_activeSocketOptions.recvBufferSize > 0)
+        m_socket.set_option(asio::socket_base::receive_buffer_size(m_activeSocketOptions.recvBufferSize), ec);
+}
+
+void Connection::addRttSample(int millis)
+{
+    // smoothed round trip time and mean deviation, as tcp estimates them (rfc 6298)
+    if (m_rtt < 0) {
+        m_rtt = millis;
+        m_rttVariance = millis / 2;
+        return;
+    }
+
+    m_rttVariance = (3 * m_rttVariance + std::abs(m_rtt - millis)) / 4;
+    m_rtt = (7 * m_rtt + millis) / 8;
+}
+
+void Connection::resetStats()
+{
+    m_bytesSent = 0;
+    m_bytesReceived = 0;
+    m_packetsSent = 0;
+    m_packetsReceived = 0;
+    m_writeCount = 0;
 }
 
 void Connection::onRecv(const boost::system::error_code& error, size_t recvSize)
 {
     m_readTimer.cancel();
-    m_activityTimer.restart();
+    if (!isNetworkThread())
+        m_activityTimer.restart();
 
     if (error == asio::error::operation_aborted)
         return;
 
     if (m_connected) {
         if (!error) {
-            if (m_recvCallback) {
-                const char* header = boost::asio::buffer_cast<const char*>(m_inputStream.data());
+            m_bytesReceived += recvSize;
+            ++m_packetsReceived;
+            const char* header = boost::asio::buffer_cast<const char*>(m_inputStream.data());
+            if (isNetworkThread())
+                pushNetworkEvent(NetworkEvent::Received, error, (const uint8*)header, recvSize);
+            else if (m_recvCallback)
                 m_recvCallback((uint8*)header, recvSize);
-            }
         }
         else
             handleError(error);
@@ -289,6 +679,94 @@ void Connection::onRecv(const boost::system::error_code& error, size_t recvSize)
         m_inputStream.consume(recvSize);
 }
 
+void Connection::onRecvMessageHeader(const boost::system::error_code& error, size_t)
+{
+    m_readTimer.cancel();
+
+    if (error == asio::error::operation_aborted || !m_connected)
+        return;
+
+    if (error) {
+        handleError(error);
+        return;
+    }
+
+    const uint16 size = stdext::readULE16(m_messageBuffer.data());
+    m_bytesReceived += 2 + size;
+    ++m_packetsReceived;
+    m_messageBuffer.resize(size);
+    asio::async_read(m_socket,
+        asio::buffer(m_messageBuffer),
+        std::bind(&Connection::onRecvMessageData, asConnection(), std::placeholders::_1, std::placeholders::_2));
+
+    m_readTimer.expires_from_now(boost::posix_time::seconds(static_cast<uint32>(READ_TIMEOUT)));
+    m_readTimer.async_wait(std::bind(&Connection::onTimeout, asConnection(), std::placeholders::_1));
+}
+
+void Connection::onRecvMessageData(const boost::system::error_code& error, size_t)
+{
+    m_readTimer.cancel();
+
+    if (error == asio::error::operation_aborted || !m_connected)
+        return;
+
+    if (error) {
+        handleError(error);
+        return;
+    }
+
+    // same checks as Protocol::internalRecvData, done here so the main thread only parses
+    uint8* data = m_messageBuffer.data();
+    size_t size = m_messageBuffer.size();
+    std::string invalid;
+
+    bool compressed = false;
+    if (m_framing.compression) {
+        // the checksum slot carries a sequence number with the compression flag instead
+        if (size < 4)
+            invalid = "invalid network message header";
+        else
+            compressed = (stdext::readULE32(data) & PacketCompression::COMPRESSED_FLAG) != 0;
+        data += 4;
+        size -= std::min<size_t>(size, 4);
+    } else if (m_framing.checksum) {
+        if (size < 4 || stdext::readULE32(data) != stdext::adler32(data + 4, size - 4))
+            invalid = "got a network message with invalid checksum";
+        data += 4;
+        size -= std::min<size_t>(size, 4);
+    }
+
+    if (invalid.empty() && m_framing.xtea) {
+        if (size == 0 || size % 8 != 0)
+            invalid = "invalid encrypted network message";
+        else {
+            stdext::xtea_decrypt((uint32*)data, size / 8, m_framing.xteaKey);
+            const uint16 decryptedSize = stdext::readULE16(data);
+            if (decryptedSize + 2u > size)
+                invalid = "invalid decrypted network message";
+            data += 2;
+            size = decryptedSize;
+        }
+    }
+
+    // the inflated message goes to the main thread in the buffer it was inflated into
+    if (invalid.empty() && compressed) {
+        MessageBufferPtr inflated = MessageBuffer::create(MessageBuffer::MAX_CAPACITY);
+        const int inflatedSize = m_compression.inflate(data, size, inflated->data(), InputMessage::BUFFER_MAXSIZE - InputMessage::MAX_HEADER_SIZE);
+        if (inflatedSize < 0)
+            invalid = "failed to decompress message";
+        else
+            pushReceivedBuffer(inflated, inflatedSize);
+    } else if (invalid.empty())
+        pushNetworkEvent(NetworkEvent::Received, error, data, size);
+
+    if (!invalid.empty())
+        pushNetworkEvent(NetworkEvent::InvalidMessage, error, (const uint8*)invalid.data(), invalid.size());
+
+    if (m_connected)
+        internal_readMessageHeader();
+}
+
 void Connection::onTimeout(const boost::system::error_code& error)
 {
     if (error == asio::error::operation_aborted)
@@ -302,6 +780,15 @@ void Connection::handleError(const boost::system::error_code& error)
     if (error == asio::error::operation_aborted)
         return;
 
+    if (isNetworkThread()) {
+        if (m_connected || m_connecting) {
+            pushNetworkEvent(NetworkEvent::Error, error);
+            m_outputQueue = nullptr;
+            internal_close();
+        }
+        return;
+    }
+
     m_error = error;
     if (m_errorCallback)
         m_errorCallback(error);
@@ -24,55 +24,142 @@
 #define CONNECTION_H
 
 #include "declarations.h"
+#include "packetcompression.h"
 #include <framework/luaengine/luaobject.h>
 #include <framework/core/timer.h>
 #include <framework/core/declarations.h>
+#include <framework/stdext/spsc_queue.h>
+#include <framework/stdext/thread.h>
+
+#include <atomic>
 
 class Connection : public LuaObject
 {
     typedef std::function<void(const boost::system::error_code&)> ErrorCallback;
     typedef std::function<void(uint8*, uint16)> RecvCallback;
 
+    // messages written in the same delayed write window, sent with a single gathered write
+    struct OutputQueue {
+        std::vector<MessageBufferPtr> buffers;
+        std::vector<asio::const_buffer> sequence;
+    };
+    typedef std::shared_ptr<OutputQueue> OutputQueuePtr;
+
+    // results of the network thread handed to the main thread
+    struct NetworkEvent {
+        enum Type { Connected, Received, InvalidMessage, Error };
+        ConnectionPtr connection;
+        Type type;
+        boost::system::error_code error;
+        std::vector<uint8> data;
+        // inflated messages are handed over in their pooled buffer instead of data
+        MessageBufferPtr buffer;
+        uint32 bufferSize;
+    };
+
     enum {
         READ_TIMEOUT = 30,
         WRITE_TIMEOUT = 30,
         SEND_BUFFER_SIZE = 65536,
-        RECV_BUFFER_SIZE = 65536
+        RECV_BUFFER_SIZE = 65536,
+        NETWORK_EVENTS_CAPACITY = 1024
     };
 
 public:
+    // how complete messages are checked and decrypted by the network thread
+    struct MessageFraming {
+        bool checksum = false;
+        bool xtea = false;
+        bool compression = false;
+        uint32 xteaKey[4] = { 0, 0, 0, 0 };
+    };
+
+    // tcp options applied when the socket connects, or right away when already connected
+    struct SocketOptions {
+        bool noDelay = true;
+        bool keepAlive = false;
+        int sendBufferSize = 0;
+        int recvBufferSize = 0;
+    };
+
     Connection();
     ~Connection();
 
     static void poll();
     static void terminate();
 
+    static void startNetworkThread();
+    static bool isNetworkThreadRunning() { return m_networkThreadRunning; }
+
     void connect(const std::string& host, uint16 port, const std::function<void()>& connectCallback);
     void close();
 
     void write(uint8* buffer, size_t size);
+    void write(const MessageBufferPtr& buffer, uint8* data, size_t size, bool immediate = false);
     void read(uint16 bytes, const RecvCallback& callback);
     void read_until(const std::string& what, const RecvCallback& callback);
     void read_some(const RecvCallback& callback);
+    void readMessages(const MessageFraming& framing, const RecvCallback& callback);
+    void setMessageFraming(const MessageFraming& framing);
 
     void setErrorCallback(const ErrorCallback& errorCallback) { m_errorCallback = errorCallback; }
 
+    void setWriteDelay(int micros) { m_writeDelay = std::max<int>(micros, 0); }
+    void setNoDelay(bool enable);
+    void setKeepAlive(bool enable);
+    void setSendBufferSize(int size);
+    void setRecvBufferSize(int size);
+    void addRttSample(int millis);
+
+    int getWriteDelay() { return m_writeDelay; }
+    bool isNoDelay() { return m_socketOptions.noDelay; }
+    bool isKeepAlive() { return m_socketOptions.keepAlive; }
+    int getSendBufferSize() { return m_socketOptions.sendBufferSize; }
+    int getRecvBufferSize() { return m_socketOptions.recvBufferSize; }
+    uint64 getBytesSent() { return m_bytesSent; }
+    uint64 getBytesReceived() { return m_bytesReceived; }
+    uint32 getPacketsSent() { return m_packetsSent; }
+    uint32 getPacketsReceived() { return m_packetsReceived; }
+    uint32 getWriteCount() { return m_writeCount; }
+    int getRtt() { return m_rtt; }
+    int getRttVariance() { return m_rttVariance; }
+    void resetStats();
+
     int getIp();
     boost::system::error_code getError() { return m_error; }
     bool isConnecting() { return m_connecting; }
     bool isConnected() { return m_connected; }
+    PacketCompression& getCompression() { return m_compression; }
     ticks_t getElapsedTicksSinceLastRead() { return m_connected ? m_activityTimer.elapsed_millis() : -1; }
 
     ConnectionPtr asConnection() { return static_self_cast<Connection>(); }
 
 protected:
+    static bool isNetworkThread();
+    static void pollNetworkEvents();
+    void pushNetworkEvent(NetworkEvent::Type type, const boost::system::error_code& error = boost::system::error_code(), const uint8* data = nullptr, size_t size = 0);
+    void pushReceivedBuffer(const MessageBufferPtr& buffer, uint32 size);
+    void handleNetworkEvent(NetworkEvent& event);
+
+    void internal_resolve(const std::string& host, uint16 port);
+    void internal_close();
+    void internal_read(uint16 bytes);
+    void internal_read_until(const std::string& what);
+    void internal_read_some();
+    void internal_readMessages(const MessageFraming& framing);
+    void internal_readMessageHeader();
+    void internal_setMessageFraming(const MessageFraming& framing) { m_framing = framing; }
     void internal_connect(asio::ip::basic_resolver<asio::ip::tcp>::iterator endpointIterator);
-    void internal_write();
+    void internal_write(bool force = false);
+    void internal_setSocketOptions(const SocketOptions& options);
+    void applySocketOptions();
     void onResolve(const boost::system::error_code& error, asio::ip::tcp::resolver::iterator endpointIterator);
     void onConnect(const boost::system::error_code& error);
     void onCanWrite(const boost::system::error_code& error);
-    void onWrite(const boost::system::error_code& error, size_t writeSize, std::shared_ptr<asio::streambuf> outputStream);
+    void onWrite(const boost::system::error_code& error, size_t writeSize, OutputQueuePtr outputQueue);
     void onRecv(const boost::system::error_code& error, size_t recvSize);
+    void onRecvMessageHeader(const boost::system::error_code& error, size_t recvSize);
+    void onRecvMessageData(const boost::system::error_code& error, size_t recvSize);
     void onTimeout(const boost::system::error_code& error);
     void handleError(const boost::system::error_code& error);
 
@@ -86,14 +173,40 @@ protected:
     asio::ip::tcp::resolver m_resolver;
     asio::ip::tcp::socket m_socket;
 
-    static std::list<std::shared_ptr<asio::streambuf>> m_outputStreams;
-    std::shared_ptr<asio::streambuf> m_outputStream;
+    static std::list<OutputQueuePtr> m_outputQueues;
+    OutputQueuePtr m_outputQueue;
+    bool m_writing;
+    bool m_flushPending;
+    // set by the main thread, read by whichever thread runs the io service
+    std::atomic<int> m_writeDelay;
+    // the main thread's copy for the getters, and the one the io service thread applies;
+    // changes reach the second one only through internal_setSocketOptions
+    SocketOptions m_socketOptions;
+    SocketOptions m_activeSocketOptions;
     asio::streambuf m_inputStream;
-    bool m_connected;
-    bool m_connecting;
+    std::atomic<bool> m_connected;
+    std::atomic<bool> m_connecting;
+
+    static std::thread m_networkThread;
+    static std::unique_ptr<asio::io_service::work> m_networkWork;
+    static std::unique_ptr<stdext::spsc_queue<NetworkEvent>> m_networkEvents;
+    static std::atomic<bool> m_networkThreadRunning;
+    MessageFraming m_framing;
+    std::vector<uint8> m_messageBuffer;
+    PacketCompression m_compression;
+    bool m_readingMessages;
     boost::system::error_code m_error;
     stdext::timer m_activityTimer;
 
+    // counted by whichever thread runs the io service, read by the main thread
+    std::atomic<uint64> m_bytesSent;
+    std::atomic<uint64> m_bytesReceived;
+    std::atomic<uint32> m_packetsSent;
+    std::atomic<uint32> m_packetsReceived;
+    std::atomic<uint32> m_writeCount;
+    int m_rtt;
+    int m_rttVariance;
+
     friend class Server;
 };
 
@@ -31,16 +31,22 @@ namespace asio = boost::asio;
 
 class InputMessage;
 class OutputMessage;
+class MessageBuffer;
 class Connection;
 class Protocol;
 class ProtocolHttp;
 class Server;
+class PacketRecorder;
+class PacketPlayer;
 
 typedef stdext::shared_object_ptr<InputMessage> InputMessagePtr;
 typedef stdext::shared_object_ptr<OutputMessage> OutputMessagePtr;
+typedef stdext::shared_object_ptr<MessageBuffer> MessageBufferPtr;
 typedef stdext::shared_object_ptr<Connection> ConnectionPtr;
 typedef stdext::shared_object_ptr<Protocol> ProtocolPtr;
 typedef stdext::shared_object_ptr<ProtocolHttp> ProtocolHttpPtr;
 typedef stdext::shared_object_ptr<Server> ServerPtr;
+typedef stdext::shared_object_ptr<PacketRecorder> PacketRecorderPtr;
+typedef stdext::shared_object_ptr<PacketPlayer> PacketPlayerPtr;
 
 #endif
@@ -79,6 +79,8 @@ protected:
     bool readChecksum();
 
     friend class Protocol;
+    friend class PacketRecorder;
+    friend class PacketPlayer;
 
 private:
     bool canRead(int bytes);
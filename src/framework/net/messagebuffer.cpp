@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "messagebuffer.h"
+
+#include <mutex>
+
+static std::mutex poolMutex;
+static bool poolThreadSafe = false;
+static std::vector<uint8*> freeBuffers[MessageBuffer::SIZE_CLASSES];
+static std::vector<void*> freeObjects;
+
+// the lock is only taken while another thread may use the pool
+static std::unique_lock<std::mutex> lockPool()
+{
+    std::unique_lock<std::mutex> lock(poolMutex, std::defer_lock);
+    if(poolThreadSafe)
+        lock.lock();
+    return lock;
+}
+
+MessageBufferPtr MessageBuffer::create(uint32 minCapacity)
+{
+    int sizeClass = getSizeClass(minCapacity);
+    uint8* data = nullptr;
+    {
+        std::unique_lock<std::mutex> lock = lockPool();
+        std::vector<uint8*>& buffers = freeBuffers[sizeClass];
+        if(!buffers.empty()) {
+            data = buffers.back();
+            buffers.pop_back();
+        }
+    }
+    if(!data)
+        data = new uint8[getClassCapacity(sizeClass)];
+    return MessageBufferPtr(new MessageBuffer(data, sizeClass));
+}
+
+void MessageBuffer::clearPool()
+{
+    std::unique_lock<std::mutex> lock = lockPool();
+    for(std::vector<uint8*>& buffers : freeBuffers) {
+        for(uint8* data : buffers)
+            delete[] data;
+        buffers.clear();
+    }
+    for(void* ptr : freeObjects)
+        ::operator delete(ptr);
+    freeObjects.clear();
+}
+
+// must be called while no other thread uses message buffers
+void MessageBuffer::setThreadSafe(bool threadSafe)
+{
+    poolThreadSafe = threadSafe;
+}
+
+void* MessageBuffer::operator new(size_t size)
+{
+    assert(size == sizeof(MessageBuffer));
+    {
+        std::unique_lock<std::mutex> lock = lockPool();
+        if(!freeObjects.empty()) {
+            void* ptr = freeObjects.back();
+            freeObjects.pop_back();
+            return ptr;
+        }
+    }
+    return ::operator new(size);
+}
+
+void MessageBuffer::operator delete(void* ptr)
+{
+    {
+        std::unique_lock<std::mutex> lock = lockPool();
+        if(freeObjects.size() < MAX_POOLED_BUFFERS * SIZE_CLASSES) {
+            freeObjects.push_back(ptr);
+            return;
+        }
+    }
+    ::operator delete(ptr);
+}
+
+MessageBuffer::MessageBuffer(uint8* data, int sizeClass)
+{
+    m_data = data;
+    m_sizeClass = sizeClass;
+    m_capacity = getClassCapacity(sizeClass);
+}
+
+MessageBuffer::~MessageBuffer()
+{
+    {
+        std::unique_lock<std::mutex> lock = lockPool();
+        std::vector<uint8*>& buffers = freeBuffers[m_sizeClass];
+        if(buffers.size() < MAX_POOLED_BUFFERS) {
+            buffers.push_back(m_data);
+            return;
+        }
+    }
+    delete[] m_data;
+}
+
+int MessageBuffer::getSizeClass(uint32 capacity)
+{
+    assert(capacity <= MAX_CAPACITY);
+    int sizeClass = 0;
+    while(sizeClass < SIZE_CLASSES - 1 && getClassCapacity(sizeClass) < capacity)
+        sizeClass++;
+    return sizeClass;
+}
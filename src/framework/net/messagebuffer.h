@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef MESSAGEBUFFER_H
+#define MESSAGEBUFFER_H
+
+#include "declarations.h"
+
+// Byte storage for network messages. Storage is allocated in a few size
+// classes and given back to a pool once the last reference goes away, so
+// a buffer can be handed over to a connection without being copied. The
+// buffer objects are pooled as well, the pool is only locked while the
+// network thread may use it.
+class MessageBuffer : public stdext::shared_object
+{
+public:
+    enum {
+        MIN_CAPACITY = 256,
+        MAX_CAPACITY = 65536,
+        SIZE_CLASSES = 5,
+        MAX_POOLED_BUFFERS = 32
+    };
+
+    static MessageBufferPtr create(uint32 minCapacity = MIN_CAPACITY);
+    static void clearPool();
+    static void setThreadSafe(bool threadSafe);
+
+    ~MessageBuffer();
+
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
+
+    uint8* data() { return m_data; }
+    uint32 capacity() { return m_capacity; }
+
+private:
+    MessageBuffer(uint8* data, int sizeClass);
+
+    static int getSizeClass(uint32 capacity);
+    static uint32 getClassCapacity(int sizeClass) { return MIN_CAPACITY << (2 * sizeClass); }
+
+    uint8* m_data;
+    uint32 m_capacity;
+    int m_sizeClass;
+};
+
+#endif
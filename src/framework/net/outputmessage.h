@@ -24,6 +24,7 @@
 #define OUTPUTMESSAGE_H
 
 #include "declarations.h"
+#include "messagebuffer.h"
 #include <framework/luaengine/luaobject.h>
 
 // @bindclass
@@ -41,7 +42,7 @@ public:
     void reset();
 
     void setBuffer(const std::string& buffer);
-    std::string getBuffer() { return std::string((char*)m_buffer + m_headerPos, m_messageSize); }
+    std::string getBuffer() { return std::string((char*)m_buffer->data() + m_headerPos, m_messageSize); }
 
     void addU8(uint8 value);
     void addU16(uint16 value);
@@ -59,13 +60,17 @@ public:
     void setMessageSize(uint16 messageSize) { m_messageSize = messageSize; }
 
 protected:
-    uint8* getWriteBuffer() { return m_buffer + m_writePos; }
-    uint8* getHeaderBuffer() { return m_buffer + m_headerPos; }
-    uint8* getDataBuffer() { return m_buffer + MAX_HEADER_SIZE; }
+    uint8* getWriteBuffer() { return m_buffer->data() + m_writePos; }
+    uint8* getHeaderBuffer() { return m_buffer->data() + m_headerPos; }
+    uint8* getDataBuffer() { return m_buffer->data() + MAX_HEADER_SIZE; }
+    const MessageBufferPtr& getMessageBuffer() { return m_buffer; }
 
     void writeChecksum();
+    void writeSequence(uint32 sequence);
     void writeMessageSize();
 
+    void setData(const MessageBufferPtr& buffer, uint16 size);
+
     friend class Protocol;
 
 private:
@@ -75,7 +80,7 @@ private:
     uint16 m_headerPos;
     uint16 m_writePos;
     uint16 m_messageSize;
-    uint8 m_buffer[BUFFER_MAXSIZE];
+    MessageBufferPtr m_buffer;
 };
 
 #endif
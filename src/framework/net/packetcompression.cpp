@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "packetcompression.h"
+
+#include <zlib.h>
+
+PacketCompression::PacketCompression() : m_level(6)
+{
+}
+
+PacketCompression::~PacketCompression()
+{
+    if(m_inflateStream)
+        inflateEnd(m_inflateStream.get());
+    if(m_deflateStream)
+        deflateEnd(m_deflateStream.get());
+}
+
+int PacketCompression::inflate(const uint8* input, uint32 inputSize, uint8* output, uint32 outputCapacity)
+{
+    if(!m_inflateStream) {
+        m_inflateStream.reset(new z_stream);
+        memset(m_inflateStream.get(), 0, sizeof(z_stream));
+        // negative window bits select raw deflate, without zlib header and trailer
+        if(inflateInit2(m_inflateStream.get(), -MAX_WBITS) != Z_OK) {
+            m_inflateStream.reset();
+            return -1;
+        }
+    } else
+        inflateReset(m_inflateStream.get());
+
+    z_stream* stream = m_inflateStream.get();
+    stream->next_in = const_cast<Bytef*>(input);
+    stream->avail_in = inputSize;
+    stream->next_out = output;
+    stream->avail_out = outputCapacity;
+
+    const int ret = ::inflate(stream, Z_FINISH);
+    if(ret != Z_STREAM_END)
+        return -1;
+
+    return outputCapacity - stream->avail_out;
+}
+
+int PacketCompression::deflate(const uint8* input, uint32 inputSize, uint8* output, uint32 outputCapacity)
+{
+    if(!m_deflateStream) {
+        m_deflateStream.reset(new z_stream);
+        memset(m_deflateStream.get(), 0, sizeof(z_stream));
+        if(deflateInit2(m_deflateStream.get(), m_level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            m_deflateStream.reset();
+            return -1;
+        }
+    } else
+        deflateReset(m_deflateStream.get());
+
+    z_stream* stream = m_deflateStream.get();
+    stream->next_in = const_cast<Bytef*>(input);
+    stream->avail_in = inputSize;
+    stream->next_out = output;
+    stream->avail_out = outputCapacity;
+
+    const int ret = ::deflate(stream, Z_FINISH);
+    if(ret != Z_STREAM_END)
+        return -1;
+
+    return outputCapacity - stream->avail_out;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PACKETCOMPRESSION_H
+#define PACKETCOMPRESSION_H
+
+#include "declarations.h"
+
+struct z_stream_s;
+
+// Raw deflate streams that live as long as their connection. Each packet
+// is a complete deflate block, the streams are only reset between packets
+// so zlib's state is allocated once.
+class PacketCompression
+{
+public:
+    enum : uint32 {
+        COMPRESSED_FLAG = 0x80000000
+    };
+
+    PacketCompression();
+    ~PacketCompression();
+
+    // both return the produced size or -1 on failure
+    int inflate(const uint8* input, uint32 inputSize, uint8* output, uint32 outputCapacity);
+    int deflate(const uint8* input, uint32 inputSize, uint8* output, uint32 outputCapacity);
+
+    void setLevel(int level) { m_level = level; }
+
+private:
+    PacketCompression(const PacketCompression&) = delete;
+    PacketCompression& operator=(const PacketCompression&) = delete;
+
+    std::unique_ptr<z_stream_s> m_inflateStream;
+    std::unique_ptr<z_stream_s> m_deflateStream;
+    int m_level;
+};
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "packetplayer.h"
+#include "inputmessage.h"
+#include <framework/core/clock.h>
+#include <framework/core/eventdispatcher.h>
+#include <framework/core/filestream.h>
+#include <framework/core/logger.h>
+#include <framework/core/resourcemanager.h>
+#include "packetrecorder.h"
+
+PacketPlayer::PacketPlayer(const std::string& fileName)
+{
+    m_fileName = fileName;
+    m_speed = 1.0f;
+    m_start = 0;
+    m_packetIndex = 0;
+
+    FileStreamPtr fin = g_resources.openFile(fileName);
+    if(!fin)
+        stdext::throw_exception(stdext::format("unable to open packet record '%s'", fileName));
+    fin->cache();
+
+    if(fin->getU32() != PacketRecorder::RECORD_SIGNATURE)
+        stdext::throw_exception(stdext::format("'%s' is not a packet record", fileName));
+
+    uint16 version = fin->getU16();
+    if(version != PacketRecorder::RECORD_VERSION)
+        stdext::throw_exception(stdext::format("packet record '%s' has unsupported version %d", fileName, version));
+
+    m_protocolVersion = fin->getU16();
+    m_clientVersion = fin->getU16();
+    m_characterName = fin->getString();
+    m_worldName = fin->getString();
+
+    // each packet is stored as timestamp (u32), size (u16) and the data,
+    // a record cut short while being written is played up to its last whole packet
+    const uint headerSize = 6;
+    while(fin->size() - fin->tell() >= headerSize) {
+        uint32 timestamp = fin->getU32();
+        uint16 size = fin->getU16();
+        if(fin->size() - fin->tell() < size)
+            break;
+
+        std::string buffer(size, '\0');
+        if(size > 0 && fin->read(&buffer[0], size) != 1)
+            break;
+        m_packets.push_back(std::make_pair(timestamp, buffer));
+    }
+
+    if(!fin->eof())
+        g_logger.warning(stdext::format("packet record '%s' is truncated, replaying its first %d packets", fileName, m_packets.size()));
+    fin->close();
+}
+
+PacketPlayer::~PacketPlayer()
+{
+    stop();
+}
+
+void PacketPlayer::start(const RecvCallback& recvCallback, const ErrorCallback& errorCallback)
+{
+    stop();
+
+    m_recvCallback = recvCallback;
+    m_errorCallback = errorCallback;
+    m_packetIndex = 0;
+    m_start = g_clock.millis();
+    m_playing = true;
+    m_processEvent = g_dispatcher.scheduleEvent(std::bind(&PacketPlayer::process, static_self_cast<PacketPlayer>()), 0);
+}
+
+void PacketPlayer::stop()
+{
+    if(m_processEvent) {
+        m_processEvent->cancel();
+        m_processEvent = nullptr;
+    }
+    m_playing = false;
+}
+
+void PacketPlayer::process()
+{
+    m_processEvent = nullptr;
+    if(!m_playing)
+        return;
+
+    // at max speed packets are fed in slices, so frames still get rendered in between
+    const ticks_t maxSliceTicks = 10;
+    const ticks_t sliceStart = stdext::millis();
+    const ticks_t elapsed = (g_clock.millis() - m_start) * m_speed;
+
+    while(m_playing && m_packetIndex < m_packets.size()) {
+        const auto& packet = m_packets[m_packetIndex];
+        if(m_speed > 0 && packet.first > elapsed)
+            break;
+        if(m_speed == 0 && stdext::millis() - sliceStart >= maxSliceTicks)
+            break;
+
+        InputMessagePtr inputMessage(new InputMessage);
+        inputMessage->fillBuffer((uint8*)packet.second.data(), packet.second.size());
+        m_packetIndex++;
+        m_recvCallback(inputMessage);
+    }
+
+    // the callbacks may have stopped the playback
+    if(!m_playing)
+        return;
+
+    // end of the record behaves like the server closing the connection
+    if(m_packetIndex >= m_packets.size()) {
+        if(m_errorCallback)
+            m_errorCallback(asio::error::eof);
+        m_playing = false;
+        return;
+    }
+
+    int delay = 0;
+    if(m_speed > 0)
+        delay = std::max<int>((m_packets[m_packetIndex].first - elapsed) / m_speed, 0);
+    m_processEvent = g_dispatcher.scheduleEvent(std::bind(&PacketPlayer::process, static_self_cast<PacketPlayer>()), delay);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PACKETPLAYER_H
+#define PACKETPLAYER_H
+
+#include "declarations.h"
+#include <framework/core/declarations.h>
+#include <framework/luaengine/luaobject.h>
+
+// @bindclass
+class PacketPlayer : public LuaObject
+{
+public:
+    typedef std::function<void(const InputMessagePtr&)> RecvCallback;
+    typedef std::function<void(const boost::system::error_code&)> ErrorCallback;
+
+    PacketPlayer(const std::string& fileName);
+    ~PacketPlayer();
+
+    void start(const RecvCallback& recvCallback, const ErrorCallback& errorCallback);
+    void stop();
+
+    // speed 0 means as fast as possible
+    void setSpeed(float speed) { m_speed = std::max<float>(speed, 0.0f); }
+    float getSpeed() { return m_speed; }
+
+    int getProtocolVersion() { return m_protocolVersion; }
+    int getClientVersion() { return m_clientVersion; }
+    std::string getCharacterName() { return m_characterName; }
+    std::string getWorldName() { return m_worldName; }
+    std::string getFileName() { return m_fileName; }
+    uint32 getPacketCount() { return m_packets.size(); }
+    uint32 getPlayedPackets() { return m_packetIndex; }
+    uint32 getDuration() { return m_packets.empty() ? 0 : m_packets.back().first; }
+    uint32 getPacketTime(uint32 index) { return index < m_packets.size() ? m_packets[index].first : 0; }
+    std::string getPacket(uint32 index) { return index < m_packets.size() ? m_packets[index].second : std::string(); }
+    bool isPlaying() { return m_playing; }
+
+private:
+    void process();
+
+    std::string m_fileName;
+    std::string m_characterName;
+    std::string m_worldName;
+    int m_protocolVersion;
+    int m_clientVersion;
+    float m_speed;
+    ticks_t m_start;
+    uint32 m_packetIndex;
+    stdext::boolean<false> m_playing;
+    std::vector<std::pair<uint32, std::string>> m_packets;
+    ScheduledEventPtr m_processEvent;
+    RecvCallback m_recvCallback;
+    ErrorCallback m_errorCallback;
+};
+
+#endif
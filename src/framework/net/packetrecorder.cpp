@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "packetrecorder.h"
+#include "inputmessage.h"
+#include <framework/core/clock.h>
+#include <framework/core/filestream.h>
+#include <framework/core/resourcemanager.h>
+
+PacketRecorder::PacketRecorder(const std::string& fileName)
+{
+    m_fileName = fileName;
+    m_start = g_clock.millis();
+    m_packets = 0;
+
+    m_stream = g_resources.createFile(fileName);
+    if(!m_stream)
+        stdext::throw_exception(stdext::format("failed to open packet record '%s' for write", fileName));
+}
+
+PacketRecorder::~PacketRecorder()
+{
+    close();
+}
+
+void PacketRecorder::writeHeader(int protocolVersion, int clientVersion, const std::string& characterName, const std::string& worldName)
+{
+    if(!m_stream)
+        return;
+
+    m_stream->addU32(RECORD_SIGNATURE);
+    m_stream->addU16(RECORD_VERSION);
+    m_stream->addU16(protocolVersion);
+    m_stream->addU16(clientVersion);
+    m_stream->addString(characterName);
+    m_stream->addString(worldName);
+}
+
+void PacketRecorder::addInputPacket(const InputMessagePtr& inputMessage)
+{
+    if(!m_stream)
+        return;
+
+    // messages are stored already decrypted, starting at the first opcode
+    uint16 size = inputMessage->getUnreadSize();
+    m_stream->addU32(g_clock.millis() - m_start);
+    m_stream->addU16(size);
+    m_stream->write(inputMessage->getReadBuffer(), size);
+    m_packets++;
+}
+
+void PacketRecorder::close()
+{
+    if(!m_stream)
+        return;
+
+    try {
+        m_stream->flush();
+        m_stream->close();
+    } catch(stdext::exception& e) {
+        g_logger.error(stdext::format("failed to close packet record '%s': %s", m_fileName, e.what()));
+    }
+    m_stream = nullptr;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PACKETRECORDER_H
+#define PACKETRECORDER_H
+
+#include "declarations.h"
+#include <framework/core/declarations.h>
+#include <framework/luaengine/luaobject.h>
+
+// @bindclass
+class PacketRecorder : public LuaObject
+{
+public:
+    enum {
+        RECORD_SIGNATURE = 0x52435450, // "PTCR"
+        RECORD_VERSION = 1
+    };
+
+    PacketRecorder(const std::string& fileName);
+    ~PacketRecorder();
+
+    void writeHeader(int protocolVersion, int clientVersion, const std::string& characterName, const std::string& worldName);
+    void addInputPacket(const InputMessagePtr& inputMessage);
+    void close();
+
+    std::string getFileName() { return m_fileName; }
+    uint32 getPacketCount() { return m_packets; }
+    bool isOpen() { return !!m_stream; }
+
+private:
+    std::string m_fileName;
+    FileStreamPtr m_stream;
+    ticks_t m_start;
+    uint32 m_packets;
+};
+
+#endif
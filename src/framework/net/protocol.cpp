@@ -22,13 +22,21 @@
 
 #include "protocol.h"
 #include "connection.h"
+#include "messagebuffer.h"
+#include "packetplayer.h"
+#include "packetrecorder.h"
 #include <framework/core/application.h>
+#include <framework/stdext/xtea.h>
 #include <random>
 
 Protocol::Protocol()
 {
     m_xteaEncryptionEnabled = false;
     m_checksumEnabled = false;
+    m_compressionEnabled = false;
+    m_outputCompressionEnabled = false;
+    m_outputSequence = 0;
+    m_readingMessages = false;
     m_inputMessage = InputMessagePtr(new InputMessage);
 }
 
@@ -42,21 +50,57 @@ Protocol::~Protocol()
 
 void Protocol::connect(const std::string& host, uint16 port)
 {
+    m_readingMessages = false;
     m_connection = ConnectionPtr(new Connection);
     m_connection->setErrorCallback(std::bind(&Protocol::onError, asProtocol(), std::placeholders::_1));
     m_connection->connect(host, port, std::bind(&Protocol::onConnect, asProtocol()));
 }
 
+void Protocol::setConnection(const ConnectionPtr& connection)
+{
+    // connections accepted by a server report their errors to the protocol using them
+    m_readingMessages = false;
+    m_connection = connection;
+    if(m_connection)
+        m_connection->setErrorCallback(std::bind(&Protocol::onError, asProtocol(), std::placeholders::_1));
+}
+
 void Protocol::disconnect()
 {
     if(m_connection) {
         m_connection->close();
         m_connection.reset();
     }
+    m_readingMessages = false;
+
+    if(m_player) {
+        m_player->stop();
+        m_player.reset();
+    }
+
+    if(m_recorder) {
+        m_recorder->close();
+        m_recorder.reset();
+    }
+}
+
+void Protocol::playRecord(const PacketPlayerPtr& player)
+{
+    disconnect();
+    m_player = player;
+    m_player->start(std::bind(&Protocol::onRecv, asProtocol(), std::placeholders::_1),
+                    std::bind(&Protocol::onError, asProtocol(), std::placeholders::_1));
+}
+
+bool Protocol::isPlayingRecord()
+{
+    return m_player && m_player->isPlaying();
 }
 
 bool Protocol::isConnected()
 {
+    if(isPlayingRecord())
+        return true;
     if(m_connection && m_connection->isConnected())
         return true;
     return false;
@@ -71,12 +115,27 @@ bool Protocol::isConnecting()
 
 void Protocol::send(const OutputMessagePtr& outputMessage)
 {
+    sendMessage(outputMessage, false);
+}
+
+void Protocol::sendMessage(const OutputMessagePtr& outputMessage, bool immediate)
+{
+    // compress
+    bool compressed = false;
+    if(m_outputCompressionEnabled)
+        compressed = deflateMessage(outputMessage);
+
     // encrypt
     if(m_xteaEncryptionEnabled)
         xteaEncrypt(outputMessage);
 
-    // write checksum
-    if(m_checksumEnabled)
+    // write sequence or checksum
+    if(m_compressionEnabled) {
+        uint32 sequence = m_outputSequence++ & ~PacketCompression::COMPRESSED_FLAG;
+        if(compressed)
+            sequence |= PacketCompression::COMPRESSED_FLAG;
+        outputMessage->writeSequence(sequence);
+    } else if(m_checksumEnabled)
         outputMessage->writeChecksum();
 
     // write message size
@@ -84,20 +143,29 @@ void Protocol::send(const OutputMessagePtr& outputMessage)
 
     // send
     if(m_connection)
-        m_connection->write(outputMessage->getHeaderBuffer(), outputMessage->getMessageSize());
+        m_connection->write(outputMessage->getMessageBuffer(), outputMessage->getHeaderBuffer(), outputMessage->getMessageSize(), immediate);
 
-    // reset message to allow reuse
+    // reset message to allow reuse, the connection keeps the sent buffer
     outputMessage->reset();
 }
 
 void Protocol::recv()
 {
+    // the network thread keeps reading on its own and hands over checked and decrypted messages
+    if(m_connection && Connection::isNetworkThreadRunning()) {
+        if(!m_readingMessages) {
+            m_readingMessages = true;
+            m_connection->readMessages(getMessageFraming(), std::bind(&Protocol::internalRecvMessage, asProtocol(), std::placeholders::_1, std::placeholders::_2));
+        }
+        return;
+    }
+
     m_inputMessage->reset();
 
     // first update message header size
     int headerSize = 2; // 2 bytes for message size
-    if(m_checksumEnabled)
-        headerSize += 4; // 4 bytes for checksum
+    if(m_checksumEnabled || m_compressionEnabled)
+        headerSize += 4; // 4 bytes for checksum or sequence
     if(m_xteaEncryptionEnabled)
         headerSize += 2; // 2 bytes for XTEA encrypted message size
     m_inputMessage->setHeaderSize(headerSize);
@@ -128,7 +196,11 @@ void Protocol::internalRecvData(uint8* buffer, uint16 size)
 
     m_inputMessage->fillBuffer(buffer, size);
 
-    if(m_checksumEnabled && !m_inputMessage->readChecksum()) {
+    bool compressed = false;
+    if(m_compressionEnabled) {
+        // the checksum slot carries a sequence number with the compression flag instead
+        compressed = (m_inputMessage->getU32() & PacketCompression::COMPRESSED_FLAG) != 0;
+    } else if(m_checksumEnabled && !m_inputMessage->readChecksum()) {
         g_logger.traceError("got a network message with invalid checksum");
         return;
     }
@@ -139,9 +211,74 @@ void Protocol::internalRecvData(uint8* buffer, uint16 size)
             return;
         }
     }
+
+    if(compressed && !inflateMessage(m_inputMessage)) {
+        g_logger.traceError("failed to decompress message");
+        return;
+    }
+
+    if(m_recorder)
+        m_recorder->addInputPacket(m_inputMessage);
+
+    onRecv(m_inputMessage);
+}
+
+void Protocol::internalRecvMessage(uint8* buffer, uint16 size)
+{
+    if(!isConnected()) {
+        g_logger.traceError("received data while disconnected");
+        return;
+    }
+
+    m_inputMessage->reset();
+    m_inputMessage->fillBuffer(buffer, size);
+
+    if(m_recorder)
+        m_recorder->addInputPacket(m_inputMessage);
+
     onRecv(m_inputMessage);
 }
 
+Connection::MessageFraming Protocol::getMessageFraming()
+{
+    Connection::MessageFraming framing;
+    framing.checksum = m_checksumEnabled;
+    framing.xtea = m_xteaEncryptionEnabled;
+    framing.compression = m_compressionEnabled;
+    for(int i = 0; i < 4; ++i)
+        framing.xteaKey[i] = m_xteaKey[i];
+    return framing;
+}
+
+void Protocol::updateMessageFraming()
+{
+    if(m_readingMessages && m_connection)
+        m_connection->setMessageFraming(getMessageFraming());
+}
+
+void Protocol::enableXteaEncryption()
+{
+    m_xteaEncryptionEnabled = true;
+    updateMessageFraming();
+}
+
+void Protocol::enableChecksum()
+{
+    m_checksumEnabled = true;
+    updateMessageFraming();
+}
+
+void Protocol::enableCompression()
+{
+    m_compressionEnabled = true;
+    updateMessageFraming();
+}
+
+void Protocol::enableOutputCompression()
+{
+    m_outputCompressionEnabled = true;
+}
+
 void Protocol::generateXteaKey()
 {
     std::mt19937 eng(std::time(nullptr));
@@ -150,6 +287,7 @@ void Protocol::generateXteaKey()
     m_xteaKey[1] = unif(eng);
     m_xteaKey[2] = unif(eng);
     m_xteaKey[3] = unif(eng);
+    updateMessageFraming();
 }
 
 void Protocol::setXteaKey(uint32 a, uint32 b, uint32 c, uint32 d)
@@ -158,6 +296,7 @@ void Protocol::setXteaKey(uint32 a, uint32 b, uint32 c, uint32 d)
     m_xteaKey[1] = b;
     m_xteaKey[2] = c;
     m_xteaKey[3] = d;
+    updateMessageFraming();
 }
 
 std::vector<uint32> Protocol::getXteaKey()
@@ -177,22 +316,7 @@ bool Protocol::xteaDecrypt(const InputMessagePtr& inputMessage)
         return false;
     }
 
-    uint32 *buffer = (uint32*)(inputMessage->getReadBuffer());
-    int readPos = 0;
-
-    while(readPos < encryptedSize/4) {
-        uint32 v0 = buffer[readPos], v1 = buffer[readPos + 1];
-        uint32 delta = 0x61C88647;
-        uint32 sum = 0xC6EF3720;
-
-        for(int32 i = 0; i < 32; i++) {
-            v1 -= ((v0 << 4 ^ v0 >> 5) + v0) ^ (sum + m_xteaKey[sum>>11 & 3]);
-            sum += delta;
-            v0 -= ((v1 << 4 ^ v1 >> 5) + v1) ^ (sum + m_xteaKey[sum & 3]);
-        }
-        buffer[readPos] = v0; buffer[readPos + 1] = v1;
-        readPos = readPos + 2;
-    }
+    stdext::xtea_decrypt((uint32*)(inputMessage->getReadBuffer()), encryptedSize / 8, m_xteaKey);
 
     uint16 decryptedSize = inputMessage->getU16() + 2;
     int sizeDelta = decryptedSize - encryptedSize;
@@ -205,6 +329,45 @@ bool Protocol::xteaDecrypt(const InputMessagePtr& inputMessage)
     return true;
 }
 
+bool Protocol::inflateMessage(const InputMessagePtr& inputMessage)
+{
+    if(!m_connection)
+        return false;
+
+    // the compressed bytes are set aside, usually a fraction of the inflated size,
+    // so the message can be inflated straight into the input message buffer
+    const uint32 compressedSize = inputMessage->getUnreadSize();
+    MessageBufferPtr buffer = MessageBuffer::create(compressedSize);
+    memcpy(buffer->data(), inputMessage->getReadBuffer(), compressedSize);
+
+    inputMessage->reset();
+    const int size = m_connection->getCompression().inflate(buffer->data(), compressedSize,
+                                                            inputMessage->getDataBuffer(), InputMessage::BUFFER_MAXSIZE - InputMessage::MAX_HEADER_SIZE);
+    if(size < 0)
+        return false;
+
+    inputMessage->setMessageSize(size);
+    return true;
+}
+
+bool Protocol::deflateMessage(const OutputMessagePtr& outputMessage)
+{
+    // tiny packets only grow when compressed
+    const uint16 size = outputMessage->getMessageSize();
+    if(!m_connection || size < 64)
+        return false;
+
+    // compressing into a fresh pooled buffer, kept only when it's actually smaller
+    MessageBufferPtr buffer = MessageBuffer::create(OutputMessage::MAX_HEADER_SIZE + size);
+    const int compressedSize = m_connection->getCompression().deflate(outputMessage->getDataBuffer(), size,
+                                                                      buffer->data() + OutputMessage::MAX_HEADER_SIZE, size - 1);
+    if(compressedSize < 0)
+        return false;
+
+    outputMessage->setData(buffer, compressedSize);
+    return true;
+}
+
 void Protocol::xteaEncrypt(const OutputMessagePtr& outputMessage)
 {
     outputMessage->writeMessageSize();
@@ -217,21 +380,7 @@ void Protocol::xteaEncrypt(const OutputMessagePtr& outputMessage)
         encryptedSize += n;
     }
 
-    int readPos = 0;
-    uint32 *buffer = (uint32*)(outputMessage->getDataBuffer() - 2);
-    while(readPos < encryptedSize / 4) {
-        uint32 v0 = buffer[readPos], v1 = buffer[readPos + 1];
-        uint32 delta = 0x61C88647;
-        uint32 sum = 0;
-
-        for(int32 i = 0; i < 32; i++) {
-            v0 += ((v1 << 4 ^ v1 >> 5) + v1) ^ (sum + m_xteaKey[sum & 3]);
-            sum -= delta;
-            v1 += ((v0 << 4 ^ v0 >> 5) + v0) ^ (sum + m_xteaKey[sum>>11 & 3]);
-        }
-        buffer[readPos] = v0; buffer[readPos + 1] = v1;
-        readPos = readPos + 2;
-    }
+    stdext::xtea_encrypt((uint32*)(outputMessage->getDataBuffer() - 2), encryptedSize / 8, m_xteaKey);
 }
 
 void Protocol::onConnect()
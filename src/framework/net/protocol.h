@@ -45,14 +45,21 @@ public:
     ticks_t getElapsedTicksSinceLastRead() { return m_connection ? m_connection->getElapsedTicksSinceLastRead() : -1; }
 
     ConnectionPtr getConnection() { return m_connection; }
-    void setConnection(const ConnectionPtr& connection) { m_connection = connection; }
+    void setConnection(const ConnectionPtr& connection);
 
     void generateXteaKey();
     void setXteaKey(uint32 a, uint32 b, uint32 c, uint32 d);
     std::vector<uint32> getXteaKey();
-    void enableXteaEncryption() { m_xteaEncryptionEnabled = true; }
+    void enableXteaEncryption();
 
-    void enableChecksum() { m_checksumEnabled = true; }
+    void enableChecksum();
+    void enableCompression();
+    void enableOutputCompression();
+
+    void setRecorder(const PacketRecorderPtr& recorder) { m_recorder = recorder; }
+    PacketRecorderPtr getRecorder() { return m_recorder; }
+    virtual void playRecord(const PacketPlayerPtr& player);
+    bool isPlayingRecord();
 
     virtual void send(const OutputMessagePtr& outputMessage);
     virtual void recv();
@@ -64,19 +71,33 @@ protected:
     virtual void onRecv(const InputMessagePtr& inputMessage);
     virtual void onError(const boost::system::error_code& err);
 
+    void sendMessage(const OutputMessagePtr& outputMessage, bool immediate);
+
     uint32 m_xteaKey[4];
 
 private:
     void internalRecvHeader(uint8* buffer, uint16 size);
     void internalRecvData(uint8* buffer, uint16 size);
+    void internalRecvMessage(uint8* buffer, uint16 size);
+
+    Connection::MessageFraming getMessageFraming();
+    void updateMessageFraming();
 
     bool xteaDecrypt(const InputMessagePtr& inputMessage);
+    bool inflateMessage(const InputMessagePtr& inputMessage);
+    bool deflateMessage(const OutputMessagePtr& outputMessage);
     void xteaEncrypt(const OutputMessagePtr& outputMessage);
 
     bool m_checksumEnabled;
     bool m_xteaEncryptionEnabled;
+    bool m_compressionEnabled;
+    bool m_outputCompressionEnabled;
+    uint32 m_outputSequence;
+    bool m_readingMessages;
     ConnectionPtr m_connection;
     InputMessagePtr m_inputMessage;
+    PacketRecorderPtr m_recorder;
+    PacketPlayerPtr m_player;
 };
 
 #endif
@@ -45,8 +45,20 @@ ServerPtr Server::create(int port)
 void Server::close()
 {
     m_isOpen = false;
-    m_acceptor.cancel();
-    m_acceptor.close();
+
+    if(Connection::isNetworkThreadRunning() && !Connection::isNetworkThread()) {
+        g_ioService.post(std::bind(&Server::internal_close, static_self_cast<Server>()));
+        return;
+    }
+
+    internal_close();
+}
+
+void Server::internal_close()
+{
+    boost::system::error_code ec;
+    m_acceptor.cancel(ec);
+    m_acceptor.close(ec);
 }
 
 void Server::acceptNext()
@@ -54,11 +66,44 @@ void Server::acceptNext()
     ConnectionPtr connection = ConnectionPtr(new Connection);
     connection->m_connecting = true;
     auto self = static_self_cast<Server>();
+
+    if(Connection::isNetworkThreadRunning() && !Connection::isNetworkThread()) {
+        // the acceptor is used by the network thread, the result comes back as a connection event
+        Connection *rawConnection = connection.get();
+        connection->m_connectCallback = [self, rawConnection] {
+            self->callLuaField("onAccept", ConnectionPtr(rawConnection), std::string(), 0);
+        };
+        connection->m_errorCallback = [self, rawConnection](const boost::system::error_code& error) {
+            self->callLuaField("onAccept", ConnectionPtr(rawConnection), error.message(), error.value());
+        };
+        g_ioService.post(std::bind(&Server::internal_acceptNext, self, connection));
+        return;
+    }
+
     m_acceptor.async_accept(connection->m_socket, [=](const boost::system::error_code& error) {
         if(!error) {
             connection->m_connected = true;
             connection->m_connecting = false;
+            connection->applySocketOptions();
         }
         self->callLuaField("onAccept", connection, error.message(), error.value());
     });
 }
+
+void Server::internal_acceptNext(const ConnectionPtr& connection)
+{
+    m_acceptor.async_accept(connection->m_socket, [connection](const boost::system::error_code& error) {
+        if(error == asio::error::operation_aborted)
+            return;
+
+        if(!error) {
+            connection->m_connected = true;
+            connection->m_connecting = false;
+            connection->applySocketOptions();
+            connection->pushNetworkEvent(Connection::NetworkEvent::Connected);
+        } else {
+            connection->m_connecting = false;
+            connection->pushNetworkEvent(Connection::NetworkEvent::Error, error);
+        }
+    });
+}
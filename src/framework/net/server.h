@@ -37,6 +37,9 @@ public:
     void acceptNext();
 
 private:
+    void internal_close();
+    void internal_acceptNext(const ConnectionPtr& connection);
+
     stdext::boolean<true> m_isOpen;
     asio::ip::tcp::acceptor m_acceptor;
 };
@@ -29,6 +29,7 @@
 #include <framework/stdext/stdext.h>
 
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include <execinfo.h>
 
 void Platform::processArgs(std::vector<std::string>& args)
@@ -158,6 +159,18 @@ double Platform::getTotalSystemMemory()
     return 0;
 }
 
+double Platform::getPeakMemoryUsage()
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024.0;
+#endif
+}
+
 std::string Platform::getOSName()
 {
     std::string line;
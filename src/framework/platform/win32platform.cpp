@@ -25,6 +25,7 @@
 #include "platform.h"
 #include <winsock2.h>
 #include <windows.h>
+#include <psapi.h>
 #include <framework/stdext/stdext.h>
 #include <boost/algorithm/string.hpp>
 #include <tchar.h>
@@ -173,6 +174,14 @@ double Platform::getTotalSystemMemory()
     return status.ullTotalPhys;
 }
 
+double Platform::getPeakMemoryUsage()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize;
+}
+
 #ifndef PRODUCT_PROFESSIONAL
 #define PRODUCT_PROFESSIONAL    0x00000030
 #define VER_SUITE_WH_SERVER     0x00008000
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "math.h"
+#include "cpu.h"
+#include "format.h"
+#include "time.h"
+
+#include <random>
+#include <vector>
+
+#ifdef STDEXT_X86
+#include <immintrin.h>
+#endif
+
+namespace stdext {
+
+static const uint32_t ADLER_MOD = 65521;
+// largest n such that 255n(n+1)/2 + (n+1)(ADLER_MOD-1) fits in 32 bits
+static const size_t ADLER_NMAX = 5552;
+
+typedef uint32_t (*adler32_kernel)(uint32_t adler, const uint8_t *buffer, size_t size);
+
+static uint32_t adler32_update(uint32_t adler, const uint8_t *buffer, size_t size)
+{
+    size_t a = adler & 0xffff, b = adler >> 16, tlen;
+    while(size > 0) {
+        tlen = size > ADLER_NMAX ? ADLER_NMAX : size;
+        size -= tlen;
+        do {
+            a += *buffer++;
+            b += a;
+        } while (--tlen);
+
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+    return (b << 16) | a;
+}
+
+#ifdef STDEXT_X86
+
+// Each 32 byte block adds the byte sum to a and the byte sums weighted by
+// 32..1 to b. b also gets 32 times the value a had before every block,
+// which is accumulated in ps and applied once per run of blocks.
+
+STDEXT_TARGET("ssse3")
+static uint32_t adler32_update_ssse3(uint32_t adler, const uint8_t *buffer, size_t size)
+{
+    const size_t BLOCK_SIZE = 32;
+    uint32_t a = adler & 0xffff, b = adler >> 16;
+
+    size_t blocks = size / BLOCK_SIZE;
+    size -= blocks * BLOCK_SIZE;
+
+    const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+
+    while(blocks > 0) {
+        size_t n = std::min<size_t>(ADLER_NMAX / BLOCK_SIZE, blocks);
+        blocks -= n;
+
+        __m128i vps = _mm_set_epi32(0, 0, 0, a * n);
+        __m128i vb = _mm_set_epi32(0, 0, 0, b);
+        __m128i va = _mm_setzero_si128();
+        do {
+            const __m128i bytes1 = _mm_loadu_si128((const __m128i*)buffer);
+            const __m128i bytes2 = _mm_loadu_si128((const __m128i*)(buffer + 16));
+            vps = _mm_add_epi32(vps, va);
+            va = _mm_add_epi32(va, _mm_sad_epu8(bytes1, zero));
+            vb = _mm_add_epi32(vb, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+            va = _mm_add_epi32(va, _mm_sad_epu8(bytes2, zero));
+            vb = _mm_add_epi32(vb, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+            buffer += BLOCK_SIZE;
+        } while(--n);
+        vb = _mm_add_epi32(vb, _mm_slli_epi32(vps, 5));
+
+        va = _mm_add_epi32(va, _mm_shuffle_epi32(va, _MM_SHUFFLE(2, 3, 0, 1)));
+        va = _mm_add_epi32(va, _mm_shuffle_epi32(va, _MM_SHUFFLE(1, 0, 3, 2)));
+        a += _mm_cvtsi128_si32(va);
+        vb = _mm_add_epi32(vb, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 3, 0, 1)));
+        vb = _mm_add_epi32(vb, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+        b = _mm_cvtsi128_si32(vb);
+
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+
+    if(size > 0)
+        return adler32_update((b << 16) | a, buffer, size);
+    return (b << 16) | a;
+}
+
+STDEXT_TARGET("avx2")
+static uint32_t adler32_update_avx2(uint32_t adler, const uint8_t *buffer, size_t size)
+{
+    const size_t BLOCK_SIZE = 32;
+    uint32_t a = adler & 0xffff, b = adler >> 16;
+
+    size_t blocks = size / BLOCK_SIZE;
+    size -= blocks * BLOCK_SIZE;
+
+    const __m256i tap = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+                                         16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    while(blocks > 0) {
+        size_t n = std::min<size_t>(ADLER_NMAX / BLOCK_SIZE, blocks);
+        blocks -= n;
+
+        __m256i vps = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, a * n);
+        __m256i vb = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, b);
+        __m256i va = _mm256_setzero_si256();
+
+        // two blocks per iteration keep two independent chains in flight
+        for(; n >= 2; n -= 2) {
+            const __m256i bytes1 = _mm256_loadu_si256((const __m256i*)buffer);
+            const __m256i bytes2 = _mm256_loadu_si256((const __m256i*)(buffer + BLOCK_SIZE));
+            const __m256i sad1 = _mm256_sad_epu8(bytes1, zero);
+            vps = _mm256_add_epi32(vps, _mm256_add_epi32(_mm256_slli_epi32(va, 1), sad1));
+            va = _mm256_add_epi32(va, _mm256_add_epi32(sad1, _mm256_sad_epu8(bytes2, zero)));
+            vb = _mm256_add_epi32(vb, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes1, tap), ones));
+            vb = _mm256_add_epi32(vb, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes2, tap), ones));
+            buffer += 2 * BLOCK_SIZE;
+        }
+        if(n > 0) {
+            const __m256i bytes = _mm256_loadu_si256((const __m256i*)buffer);
+            vps = _mm256_add_epi32(vps, va);
+            va = _mm256_add_epi32(va, _mm256_sad_epu8(bytes, zero));
+            vb = _mm256_add_epi32(vb, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+            buffer += BLOCK_SIZE;
+        }
+        vb = _mm256_add_epi32(vb, _mm256_slli_epi32(vps, 5));
+
+        __m128i sa = _mm_add_epi32(_mm256_castsi256_si128(va), _mm256_extracti128_si256(va, 1));
+        sa = _mm_add_epi32(sa, _mm_shuffle_epi32(sa, _MM_SHUFFLE(2, 3, 0, 1)));
+        sa = _mm_add_epi32(sa, _mm_shuffle_epi32(sa, _MM_SHUFFLE(1, 0, 3, 2)));
+        a += _mm_cvtsi128_si32(sa);
+        __m128i sb = _mm_add_epi32(_mm256_castsi256_si128(vb), _mm256_extracti128_si256(vb, 1));
+        sb = _mm_add_epi32(sb, _mm_shuffle_epi32(sb, _MM_SHUFFLE(2, 3, 0, 1)));
+        sb = _mm_add_epi32(sb, _mm_shuffle_epi32(sb, _MM_SHUFFLE(1, 0, 3, 2)));
+        b = _mm_cvtsi128_si32(sb);
+
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+
+    if(size > 0)
+        return adler32_update((b << 16) | a, buffer, size);
+    return (b << 16) | a;
+}
+
+#endif
+
+struct adler32_implementation {
+    const char* name;
+    adler32_kernel update;
+};
+
+static std::vector<adler32_implementation> available_adler32_implementations()
+{
+    std::vector<adler32_implementation> implementations;
+    implementations.push_back({"scalar", &adler32_update});
+#ifdef STDEXT_X86
+    if(cpu_has_ssse3())
+        implementations.push_back({"ssse3", &adler32_update_ssse3});
+    if(cpu_has_avx2())
+        implementations.push_back({"avx2", &adler32_update_avx2});
+#endif
+    return implementations;
+}
+
+uint32_t adler32(const uint8_t *buffer, size_t size)
+{
+    static const adler32_kernel update = available_adler32_implementations().back().update;
+    // short buffers are not worth the vector setup
+    if(size < 64)
+        return adler32_update(1, buffer, size);
+    return update(1, buffer, size);
+}
+
+uint32_t adler32_scalar(const uint8_t *buffer, size_t size)
+{
+    return adler32_update(1, buffer, size);
+}
+
+bool adler32_self_test()
+{
+    // known answer from the adler32 definition
+    const std::string wikipedia = "Wikipedia";
+    if(adler32_scalar((const uint8_t*)wikipedia.data(), wikipedia.size()) != 0x11E60398)
+        return false;
+
+    // all 0xff bytes make both sums grow as fast as possible, checking the modulo points
+    std::mt19937 gen(1234);
+    const size_t sizes[] = { 0, 1, 31, 32, 33, 63, 64, 65, 100, 5551, 5552, 5553, 11104, 65535, 65536 };
+    for(const adler32_implementation& implementation : available_adler32_implementations()) {
+        for(size_t size : sizes) {
+            std::vector<uint8_t> random(size), full(size, 0xff);
+            for(uint8_t& byte : random)
+                byte = gen();
+
+            for(const std::vector<uint8_t>* data : { &random, &full }) {
+                if(implementation.update(1, data->data(), size) != adler32_scalar(data->data(), size))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::string adler32_benchmark(size_t bytes, int iterations)
+{
+    std::vector<uint8_t> data(std::max<size_t>(bytes, 1));
+    for(size_t i = 0; i < data.size(); ++i)
+        data[i] = i * 7;
+
+    std::string report;
+    uint32_t checksum = 0;
+    for(const adler32_implementation& implementation : available_adler32_implementations()) {
+        timer t;
+        for(int i = 0; i < iterations; ++i)
+            checksum ^= implementation.update(1, data.data(), data.size());
+        double seconds = std::max<double>(t.elapsed_micros(), 1) / 1000000.0;
+        double megabytes = (data.size() * (double)iterations) / (1024.0 * 1024.0);
+        report += format("adler32 %s: %.1f MB/s\n", implementation.name, megabytes / seconds);
+    }
+    // keeps the loops from being optimized away
+    if(checksum == 0xffffffff)
+        report += "\n";
+    return report;
+}
+
+}
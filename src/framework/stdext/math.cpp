@@ -29,22 +29,6 @@
 
 namespace stdext {
 
-uint32_t adler32(const uint8_t *buffer, size_t size) {
-    size_t a = 1, b = 0, tlen;
-    while(size > 0) {
-        tlen = size > 5552 ? 5552 : size;
-        size -= tlen;
-        do {
-            a += *buffer++;
-            b += a;
-        } while (--tlen);
-
-        a %= 65521;
-        b %= 65521;
-    }
-    return (b << 16) | a;
-}
-
 long random_range(long min, long max)
 {
     static std::random_device rd;
@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include "types.h"
+#include <string>
 
 namespace stdext {
 
@@ -48,6 +49,9 @@ inline void writeSLE32(uchar *addr, int32_t value) { writeSLE16(addr + 2, value
 inline void writeSLE64(uchar *addr, int64_t value) { writeSLE32(addr + 4, value >> 32); writeSLE32(addr, static_cast<int32_t>(value)); }
 
 uint32_t adler32(const uint8_t *buffer, size_t size);
+uint32_t adler32_scalar(const uint8_t *buffer, size_t size);
+bool adler32_self_test();
+std::string adler32_benchmark(size_t bytes, int iterations);
 
 long random_range(long min, long max);
 float random_range(float min, float max);
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef STDEXT_SPSC_QUEUE_H
+#define STDEXT_SPSC_QUEUE_H
+
+#include "types.h"
+#include <atomic>
+#include <vector>
+
+namespace stdext {
+
+// bounded lock free queue for exactly one producer thread and one consumer thread,
+// slots are filled and read in place so whatever they own (like vector capacity) is reused
+template<typename T>
+class spsc_queue {
+public:
+    explicit spsc_queue(std::size_t capacity) : m_head(0), m_tail(0) {
+        std::size_t size = 1;
+        while(size < capacity)
+            size <<= 1;
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    // producer side, returns nullptr when full
+    T* back() {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if(head - m_tail.load(std::memory_order_acquire) == m_slots.size())
+            return nullptr;
+        return &m_slots[head & m_mask];
+    }
+    void push() { m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // consumer side, returns nullptr when empty
+    T* front() {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if(tail == m_head.load(std::memory_order_acquire))
+            return nullptr;
+        return &m_slots[tail & m_mask];
+    }
+    void pop() { m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool empty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+    std::size_t capacity() const { return m_slots.size(); }
+
+private:
+    // head and tail are written by different threads, keep them on different cache lines
+    alignas(64) std::atomic<std::size_t> m_head;
+    alignas(64) std::atomic<std::size_t> m_tail;
+    std::vector<T> m_slots;
+    std::size_t m_mask;
+};
+
+}
+
+#endif
@@ -27,6 +27,7 @@
 #include "boolean.h"
 #include "cast.h"
 #include "compiler.h"
+#include "cpu.h"
 #include "demangle.h"
 #include "dumper.h"
 #include "dynamic_storage.h"
@@ -36,8 +37,10 @@
 #include "packed_any.h"
 #include "packed_storage.h"
 #include "shared_object.h"
+#include "spsc_queue.h"
 #include "string.h"
 #include "time.h"
 #include "types.h"
+#include "xtea.h"
 
 #endif
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "xtea.h"
+#include "cpu.h"
+#include "format.h"
+#include "time.h"
+
+#include <random>
+#include <vector>
+
+#ifdef STDEXT_X86
+#include <immintrin.h>
+#endif
+
+namespace stdext {
+
+static const uint32_t XTEA_DELTA = 0x61C88647;
+static const int XTEA_ROUNDS = 32;
+
+// the sum schedule does not depend on the data, so the key words of each round are computed once
+struct xtea_round_keys {
+    uint32_t k0[XTEA_ROUNDS];
+    uint32_t k1[XTEA_ROUNDS];
+};
+
+typedef void (*xtea_kernel)(uint32_t* buffer, size_t blocks, const xtea_round_keys& keys);
+
+static void encrypt_round_keys(xtea_round_keys& keys, const uint32_t key[4])
+{
+    uint32_t sum = 0;
+    for(int i = 0; i < XTEA_ROUNDS; i++) {
+        keys.k0[i] = sum + key[sum & 3];
+        sum -= XTEA_DELTA;
+        keys.k1[i] = sum + key[sum>>11 & 3];
+    }
+}
+
+static void decrypt_round_keys(xtea_round_keys& keys, const uint32_t key[4])
+{
+    uint32_t sum = 0xC6EF3720;
+    for(int i = 0; i < XTEA_ROUNDS; i++) {
+        keys.k1[i] = sum + key[sum>>11 & 3];
+        sum += XTEA_DELTA;
+        keys.k0[i] = sum + key[sum & 3];
+    }
+}
+
+static void encrypt_blocks(uint32_t* buffer, size_t blocks, const xtea_round_keys& keys)
+{
+    for(size_t b = 0; b < blocks; b++, buffer += 2) {
+        uint32_t v0 = buffer[0], v1 = buffer[1];
+        for(int i = 0; i < XTEA_ROUNDS; i++) {
+            v0 += ((v1 << 4 ^ v1 >> 5) + v1) ^ keys.k0[i];
+            v1 += ((v0 << 4 ^ v0 >> 5) + v0) ^ keys.k1[i];
+        }
+        buffer[0] = v0; buffer[1] = v1;
+    }
+}
+
+static void decrypt_blocks(uint32_t* buffer, size_t blocks, const xtea_round_keys& keys)
+{
+    for(size_t b = 0; b < blocks; b++, buffer += 2) {
+        uint32_t v0 = buffer[0], v1 = buffer[1];
+        for(int i = 0; i < XTEA_ROUNDS; i++) {
+            v1 -= ((v0 << 4 ^ v0 >> 5) + v0) ^ keys.k1[i];
+            v0 -= ((v1 << 4 ^ v1 >> 5) + v1) ^ keys.k0[i];
+        }
+        buffer[0] = v0; buffer[1] = v1;
+    }
+}
+
+#ifdef STDEXT_X86
+
+// blocks are split into a vector of first words and a vector of second words, one block per lane
+
+STDEXT_TARGET("sse2")
+static void encrypt_blocks_sse2(uint32_t* buffer, size_t blocks, const xtea_round_keys& keys)
+{
+    size_t b = 0;
+    for(; b + 4 <= blocks; b += 4) {
+        __m128i* p = (__m128i*)(buffer + b * 2);
+        __m128 x = _mm_castsi128_ps(_mm_loadu_si128(p));
+        __m128 y = _mm_castsi128_ps(_mm_loadu_si128(p + 1));
+        __m128i v0 = _mm_castps_si128(_mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i v1 = _mm_castps_si128(_mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+        for(int i = 0; i < XTEA_ROUNDS; i++) {
+            __m128i f = _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v1, 4), _mm_srli_epi32(v1, 5)), v1);
+            v0 = _mm_add_epi32(v0, _mm_xor_si128(f, _mm_set1_epi32(keys.k0[i])));
+            f = _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v0, 4), _mm_srli_epi32(v0, 5)), v0);
+            v1 = _mm_add_epi32(v1, _mm_xor_si128(f, _mm_set1_epi32(keys.k1[i])));
+        }
+        _mm_storeu_si128(p, _mm_unpacklo_epi32(v0, v1));
+        _mm_storeu_si128(p + 1, _mm_unpackhi_epi32(v0, v1));
+    }
+    encrypt_blocks(buffer + b * 2, blocks - b, keys);
+}
+
+STDEXT_TARGET("sse2")
+static void decrypt_blocks_sse2(uint32_t* buffer, size_t blocks, const xtea_round_keys& keys)
+{
+    size_t b = 0;
+    for(; b + 4 <= blocks; b += 4) {
+        __m128i* p = (__m128i*)(buffer + b * 2);
+        __m128 x = _mm_castsi128_ps(_mm_loadu_si128(p));
+        __m128 y = _mm_castsi128_ps(_mm_loadu_si128(p + 1));
+        __m128i v0 = _mm_castps_si128(_mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i v1 = _mm_castps_si128(_mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+        for(int i = 0; i < XTEA_ROUNDS; i++) {
+            __m128i f = _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v0, 4), _mm_srli_epi32(v0, 5)), v0);
+            v1 = _mm_sub_epi32(v1, _mm_xor_si128(f, _mm_set1_epi32(keys.k1[i])));
+            f = _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v1, 4), _mm_srli_epi32(v1, 5)), v1);
+            v0 = _mm_sub_epi32(v0, _mm_xor_si128(f, _mm_set1_epi32(keys.k0[i])));
+        }
+        _mm_storeu_si128(p, _mm_unpacklo_epi32(v0, v1));
+        _mm_storeu_si128(p + 1, _mm_unpackhi_epi32(v0, v1));
+    }
+    decrypt_blocks(buffer + b * 2, blocks - b, keys);
+}
+
+// the in lane shuffles permute the block order, unpacking restores it
+STDEXT_TARGET("avx2")
+static void encrypt_blocks_avx2(uint32_t* buffer, size_t blocks, const xtea_round_keys& keys)
+{
+    size_t b = 0;
+    for(; b + 8 <= blocks; b += 8) {
+        __m256i* p = (__m256i*)(buffer + b * 2);
+        __m256 x = _mm256_castsi256_ps(_mm256_loadu_si256(p));
+        __m256 y = _mm256_castsi256_ps(_mm256_loadu_si256(p + 1));
+        __m256i v0 = _mm256_castps_si256(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m256i v1 = _mm256_castps_si256(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+        for(int i = 0; i < XTEA_ROUNDS; i++) {
+            __m256i f = _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v1, 4), _mm256_srli_epi32(v1, 5)), v1);
+            v0 = _mm256_add_epi32(v0, _mm256_xor_si256(f, _mm256_set1_epi32(keys.k0[i])));
+            f = _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v0, 4), _mm256_srli_epi32(v0, 5)), v0);
+            v1 = _mm256_add_epi32(v1, _mm256_xor_si256(f, _mm256_set1_epi32(keys.k1[i])));
+        }
+        _mm256_storeu_si256(p, _mm256_unpacklo_epi32(v0, v1));
+        _mm256_storeu_si256(p + 1, _mm256_unpackhi_epi32(v0, v1));
+    }
+    encrypt_blocks_sse2(buffer + b * 2, blocks - b, keys);
+}
+
+STDEXT_TARGET("avx2")
+static void decrypt_blocks_avx2(uint32_t* buffer, size_t blocks, const xtea_round_keys& keys)
+{
+    size_t b = 0;
+    for(; b + 8 <= blocks; b += 8) {
+        __m256i* p = (__m256i*)(buffer + b * 2);
+        __m256 x = _mm256_castsi256_ps(_mm256_loadu_si256(p));
+        __m256 y = _mm256_castsi256_ps(_mm256_loadu_si256(p + 1));
+        __m256i v0 = _mm256_castps_si256(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m256i v1 = _mm256_castps_si256(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+        for(int i = 0; i < XTEA_ROUNDS; i++) {
+            __m256i f = _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v0, 4), _mm256_srli_epi32(v0, 5)), v0);
+            v1 = _mm256_sub_epi32(v1, _mm256_xor_si256(f, _mm256_set1_epi32(keys.k1[i])));
+            f = _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v1, 4), _mm256_srli_epi32(v1, 5)), v1);
+            v0 = _mm256_sub_epi32(v0, _mm256_xor_si256(f, _mm256_set1_epi32(keys.k0[i])));
+        }
+        _mm256_storeu_si256(p, _mm256_unpacklo_epi32(v0, v1));
+        _mm256_storeu_si256(p + 1, _mm256_unpackhi_epi32(v0, v1));
+    }
+    decrypt_blocks_sse2(buffer + b * 2, blocks - b, keys);
+}
+
+#endif
+
+struct xtea_implementation {
+    const char* name;
+    xtea_kernel encrypt;
+    xtea_kernel decrypt;
+};
+
+static std::vector<xtea_implementation> available_implementations()
+{
+    std::vector<xtea_implementation> implementations;
+    implementations.push_back({"scalar", &encrypt_blocks, &decrypt_blocks});
+#ifdef STDEXT_X86
+    if(cpu_has_sse2())
+        implementations.push_back({"sse2", &encrypt_blocks_sse2, &decrypt_blocks_sse2});
+    if(cpu_has_avx2())
+        implementations.push_back({"avx2", &encrypt_blocks_avx2, &decrypt_blocks_avx2});
+#endif
+    return implementations;
+}
+
+static const xtea_implementation& best_implementation()
+{
+    static const xtea_implementation implementation = available_implementations().back();
+    return implementation;
+}
+
+void xtea_encrypt(uint32_t* buffer, size_t blocks, const uint32_t key[4])
+{
+    xtea_round_keys keys;
+    encrypt_round_keys(keys, key);
+    best_implementation().encrypt(buffer, blocks, keys);
+}
+
+void xtea_decrypt(uint32_t* buffer, size_t blocks, const uint32_t key[4])
+{
+    xtea_round_keys keys;
+    decrypt_round_keys(keys, key);
+    best_implementation().decrypt(buffer, blocks, keys);
+}
+
+void xtea_encrypt_scalar(uint32_t* buffer, size_t blocks, const uint32_t key[4])
+{
+    for(size_t b = 0; b < blocks; b++, buffer += 2) {
+        uint32_t v0 = buffer[0], v1 = buffer[1];
+        uint32_t delta = XTEA_DELTA;
+        uint32_t sum = 0;
+
+        for(int32_t i = 0; i < XTEA_ROUNDS; i++) {
+            v0 += ((v1 << 4 ^ v1 >> 5) + v1) ^ (sum + key[sum & 3]);
+            sum -= delta;
+            v1 += ((v0 << 4 ^ v0 >> 5) + v0) ^ (sum + key[sum>>11 & 3]);
+        }
+        buffer[0] = v0; buffer[1] = v1;
+    }
+}
+
+void xtea_decrypt_scalar(uint32_t* buffer, size_t blocks, const uint32_t key[4])
+{
+    for(size_t b = 0; b < blocks; b++, buffer += 2) {
+        uint32_t v0 = buffer[0], v1 = buffer[1];
+        uint32_t delta = XTEA_DELTA;
+        uint32_t sum = 0xC6EF3720;
+
+        for(int32_t i = 0; i < XTEA_ROUNDS; i++) {
+            v1 -= ((v0 << 4 ^ v0 >> 5) + v0) ^ (sum + key[sum>>11 & 3]);
+            sum += delta;
+            v0 -= ((v1 << 4 ^ v1 >> 5) + v1) ^ (sum + key[sum & 3]);
+        }
+        buffer[0] = v0; buffer[1] = v1;
+    }
+}
+
+bool xtea_self_test()
+{
+    // published xtea test vector, its byte strings taken as big endian words;
+    // the kernels work on word values, so the host byte order does not matter
+    const uint32_t knownKey[4] = { 0x00010203, 0x04050607, 0x08090a0b, 0x0c0d0e0f };
+    const uint32_t knownPlain[2] = { 0x41424344, 0x45464748 };
+    const uint32_t knownCipher[2] = { 0x497df3d0, 0x72612cb5 };
+
+    uint32_t block[2] = { knownPlain[0], knownPlain[1] };
+    xtea_encrypt_scalar(block, 1, knownKey);
+    if(block[0] != knownCipher[0] || block[1] != knownCipher[1])
+        return false;
+    xtea_decrypt_scalar(block, 1, knownKey);
+    if(block[0] != knownPlain[0] || block[1] != knownPlain[1])
+        return false;
+
+    // block counts around the vector widths exercise the tails
+    std::mt19937 gen(1234);
+    const size_t blockCounts[] = { 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33, 1000 };
+    for(const xtea_implementation& implementation : available_implementations()) {
+        for(size_t blocks : blockCounts) {
+            uint32_t key[4] = { static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()) };
+            std::vector<uint32_t> plain(blocks * 2);
+            for(uint32_t& word : plain)
+                word = static_cast<uint32_t>(gen());
+
+            std::vector<uint32_t> expected = plain;
+            std::vector<uint32_t> data = plain;
+            xtea_round_keys keys;
+
+            xtea_encrypt_scalar(expected.data(), blocks, key);
+            encrypt_round_keys(keys, key);
+            implementation.encrypt(data.data(), blocks, keys);
+            if(data != expected)
+                return false;
+
+            decrypt_round_keys(keys, key);
+            implementation.decrypt(data.data(), blocks, keys);
+            if(data != plain)
+                return false;
+        }
+    }
+    return true;
+}
+
+std::string xtea_benchmark(size_t bytes, int iterations)
+{
+    const size_t blocks = std::max<size_t>(bytes / 8, 1);
+    std::vector<uint32_t> data(blocks * 2, 0x5a5a5a5a);
+    const uint32_t key[4] = { 1, 2, 3, 4 };
+    xtea_round_keys keys;
+    decrypt_round_keys(keys, key);
+
+    std::string report;
+    for(const xtea_implementation& implementation : available_implementations()) {
+        timer t;
+        for(int i = 0; i < iterations; ++i)
+            implementation.decrypt(data.data(), blocks, keys);
+        double seconds = std::max<double>(t.elapsed_micros(), 1) / 1000000.0;
+        double megabytes = (blocks * 8.0 * iterations) / (1024.0 * 1024.0);
+        report += format("xtea %s: %.1f MB/s\n", implementation.name, megabytes / seconds);
+    }
+    return report;
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2010-2020 OTClient <https://github.com/edubart/otclient>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef STDEXT_XTEA_H
+#define STDEXT_XTEA_H
+
+#include "types.h"
+#include <string>
+
+namespace stdext {
+
+// xtea with 32 rounds over 8 byte blocks, as used by the game protocol
+void xtea_encrypt(uint32_t* buffer, size_t blocks, const uint32_t key[4]);
+void xtea_decrypt(uint32_t* buffer, size_t blocks, const uint32_t key[4]);
+
+// one block at a time reference implementation
+void xtea_encrypt_scalar(uint32_t* buffer, size_t blocks, const uint32_t key[4]);
+void xtea_decrypt_scalar(uint32_t* buffer, size_t blocks, const uint32_t key[4]);
+
+// checks a known answer and that every vectorized path matches the reference
+bool xtea_self_test();
+// decrypt throughput of every available implementation
+std::string xtea_benchmark(size_t bytes, int iterations);
+
+}
+
+#endif
@@ -269,6 +269,34 @@ void UIManager::onWidgetDisappear(const UIWidgetPtr& widget)
         updateHoveredWidget();
 }
 
+void UIManager::onWidgetIdChange(UIWidget* widget, const std::string& oldId, const std::string& newId)
+{
+    if (!oldId.empty()) {
+        auto it = m_widgetsById.find(oldId);
+        if (it != m_widgetsById.end()) {
+            std::vector<UIWidget*>& widgets = it->second;
+            auto wit = std::find(widgets.begin(), widgets.end(), widget);
+            if (wit != widgets.end()) {
+                *wit = widgets.back();
+                widgets.pop_back();
+            }
+            if (widgets.empty())
+                m_widgetsById.erase(it);
+        }
+    }
+
+    if (!newId.empty())
+        m_widgetsById[newId].push_back(widget);
+}
+
+const std::vector<UIWidget*>* UIManager::getWidgetsById(const std::string& id)
+{
+    auto it = m_widgetsById.find(id);
+    if (it == m_widgetsById.end())
+        return nullptr;
+    return &it->second;
+}
+
 void UIManager::onWidgetDestroy(const UIWidgetPtr& widget)
 {
     // release input grabs
@@ -74,6 +74,8 @@ protected:
     void onWidgetAppear(const UIWidgetPtr& widget);
     void onWidgetDisappear(const UIWidgetPtr& widget);
     void onWidgetDestroy(const UIWidgetPtr& widget);
+    void onWidgetIdChange(UIWidget* widget, const std::string& oldId, const std::string& newId);
+    const std::vector<UIWidget*>* getWidgetsById(const std::string& id);
 
     friend class UIWidget;
 
@@ -89,6 +91,7 @@ private:
     std::unordered_map<std::string, OTMLNodePtr> m_styles;
     UIWidgetList m_destroyedWidgets;
     ScheduledEventPtr m_checkEvent;
+    std::unordered_map<std::string, std::vector<UIWidget*>> m_widgetsById; // weak, widgets unregister when released
 
 };
 
@@ -119,6 +119,9 @@ void UITextEdit::drawSelf(Fw::DrawPane drawPane)
         } else if(elapsed >= 2 * delay) {
             m_cursorTicks = g_clock.millis();
         }
+
+        // the blinking cursor keeps a cached parent repainting while focused
+        invalidateRenderCache();
     }
 
     g_painter->resetColor();
@@ -332,6 +335,7 @@ void UITextEdit::update(bool focusCursor)
     if(fireAreaUpdate)
         onTextAreaUpdate(m_textVirtualOffset, m_textVirtualSize, m_textTotalSize);
 
+    invalidateRenderCache();
     g_app.repaint();
 }
 
@@ -455,6 +459,7 @@ void UITextEdit::removeCharacter(bool right)
 void UITextEdit::blinkCursor()
 {
     m_cursorTicks = g_clock.millis();
+    invalidateRenderCache();
     g_app.repaint();
 }
 
@@ -28,6 +28,7 @@
 #include <framework/core/eventdispatcher.h>
 #include <framework/otml/otmlnode.h>
 #include <framework/graphics/graphics.h>
+#include <framework/graphics/framebuffermanager.h>
 #include <framework/platform/platformwindow.h>
 #include <framework/graphics/texturemanager.h>
 #include <framework/core/application.h>
@@ -53,10 +54,18 @@ UIWidget::~UIWidget()
     if (!m_destroyed)
         g_logger.warning(stdext::format("widget '%s' was not explicitly destroyed", m_id));
 #endif
+    g_ui.onWidgetIdChange(this, m_id, std::string());
 }
 
 void UIWidget::draw(const Rect& visibleRect, Fw::DrawPane drawPane)
 {
+    // cached subtrees are only repainted when something inside them changed,
+    // background pane contents are animated and always drawn directly
+    if (m_renderCache && !m_renderCacheDrawing && drawPane == Fw::ForegroundPane && m_rotation == 0.0f && m_rect.isValid() && g_graphics.canUseFBO()) {
+        drawRenderCache(visibleRect);
+        return;
+    }
+
     Rect oldClipRect;
     if (m_clipping) {
         oldClipRect = g_painter->getClipRect();
@@ -103,6 +112,35 @@ void UIWidget::drawSelf(Fw::DrawPane drawPane)
     drawBorder(m_rect);
 }
 
+void UIWidget::drawRenderCache(const Rect& visibleRect)
+{
+    if (!m_renderCacheFramebuffer) {
+        m_renderCacheFramebuffer = g_framebuffers.createFrameBuffer();
+        m_renderCacheFramebuffer->setSmooth(false);
+        m_renderCacheDirty = true;
+    }
+
+    if (m_renderCacheDirty || m_renderCacheFramebuffer->getSize() != m_rect.size()) {
+        m_renderCacheDirty = false;
+
+        // the framebuffer covers only this widget, but is painted with screen coords
+        m_renderCacheFramebuffer->resize(m_rect.size());
+        m_renderCacheFramebuffer->bind();
+        g_painter->setResolution(m_rect.size(), m_rect.topLeft());
+        g_painter->setAlphaWriting(true);
+        g_painter->clear(Color::alpha);
+
+        m_renderCacheDrawing = true;
+        draw(m_rect, Fw::ForegroundPane);
+        m_renderCacheDrawing = false;
+
+        m_renderCacheFramebuffer->release();
+    }
+
+    g_painter->resetColor();
+    m_renderCacheFramebuffer->draw(visibleRect, visibleRect.translated(-m_rect.topLeft()));
+}
+
 void UIWidget::drawChildren(const Rect& visibleRect, Fw::DrawPane drawPane)
 {
     // draw children
@@ -155,6 +193,7 @@ void UIWidget::addChild(const UIWidgetPtr& child)
     UIWidgetPtr oldLastChild = getLastChild();
 
     m_children.push_back(child);
+    indexChildId(child, true);
     child->setParent(static_self_cast<UIWidget>());
 
     // create default layout
@@ -173,6 +212,7 @@ void UIWidget::addChild(const UIWidgetPtr& child)
         oldLastChild->updateState(Fw::LastState);
     }
 
+    invalidateRenderCache();
     g_ui.onWidgetAppear(child);
 }
 
@@ -198,6 +238,7 @@ void UIWidget::insertChild(int index, const UIWidgetPtr& child)
     // retrieve child by index
     auto it = m_children.begin() + index;
     m_children.insert(it, child);
+    indexChildId(child, false);
     child->setParent(static_self_cast<UIWidget>());
 
     // create default layout if needed
@@ -211,6 +252,7 @@ void UIWidget::insertChild(int index, const UIWidgetPtr& child)
     child->updateStates();
     updateChildrenIndexStates();
 
+    invalidateRenderCache();
     g_ui.onWidgetAppear(child);
 }
 
@@ -230,6 +272,7 @@ void UIWidget::removeChild(UIWidgetPtr child)
 
         auto it = std::find(m_children.begin(), m_children.end(), child);
         m_children.erase(it);
+        unindexChildId(child, child->getId());
 
         // reset child parent
         assert(child->getParent() == static_self_cast<UIWidget>());
@@ -244,6 +287,7 @@ void UIWidget::removeChild(UIWidgetPtr child)
         if (m_autoFocusPolicy != Fw::AutoFocusNone && focusAnother && !m_focusedChild)
             focusPreviousChild(Fw::ActiveFocusReason, true);
 
+        invalidateRenderCache();
         g_ui.onWidgetDisappear(child);
     }
     else
@@ -391,7 +435,9 @@ void UIWidget::lowerChild(UIWidgetPtr child)
 
     m_children.erase(it);
     m_children.push_front(child);
+    reindexChildId(child->getId());
     updateChildrenIndexStates();
+    invalidateRenderCache();
 }
 
 void UIWidget::raiseChild(UIWidgetPtr child)
@@ -410,7 +456,9 @@ void UIWidget::raiseChild(UIWidgetPtr child)
     }
     m_children.erase(it);
     m_children.push_back(child);
+    reindexChildId(child->getId());
     updateChildrenIndexStates();
+    invalidateRenderCache();
 }
 
 void UIWidget::moveChildToIndex(const UIWidgetPtr& child, int index)
@@ -434,8 +482,10 @@ void UIWidget::moveChildToIndex(const UIWidgetPtr& child, int index)
     }
     m_children.erase(it);
     m_children.insert(m_children.begin() + index - 1, child);
+    reindexChildId(child->getId());
     updateChildrenIndexStates();
     updateLayout();
+    invalidateRenderCache();
 }
 
 void UIWidget::lockChild(const UIWidgetPtr& child)
@@ -765,10 +815,12 @@ void UIWidget::internalDestroy()
     }
     m_parent = nullptr;
     m_lockedChildren.clear();
+    setRenderCache(false);
 
     for (const UIWidgetPtr& child : m_children)
         child->internalDestroy();
     m_children.clear();
+    m_childrenById.clear();
 
     callLuaField("onDestroy");
 
@@ -800,6 +852,7 @@ void UIWidget::destroyChildren()
 
     m_focusedChild = nullptr;
     m_lockedChildren.clear();
+    m_childrenById.clear();
     while (!m_children.empty()) {
         UIWidgetPtr child = m_children.front();
         m_children.pop_front();
@@ -815,7 +868,16 @@ void UIWidget::destroyChildren()
 void UIWidget::setId(const std::string& id)
 {
     if (id != m_id) {
+        const std::string oldId = m_id;
         m_id = id;
+
+        g_ui.onWidgetIdChange(this, oldId, id);
+        if (UIWidgetPtr parent = getParent()) {
+            UIWidgetPtr self = static_self_cast<UIWidget>();
+            parent->unindexChildId(self, oldId);
+            parent->indexChildId(self, false);
+        }
+
         callLuaField("onIdChange", id);
     }
 }
@@ -887,6 +949,7 @@ bool UIWidget::setRect(const Rect& rect)
         return false;
 
     m_rect = rect;
+    invalidateRenderCache();
 
     // updates own layout
     updateLayout();
@@ -943,6 +1006,7 @@ void UIWidget::setVisible(bool visible)
 {
     if (m_visible != visible) {
         m_visible = visible;
+        invalidateRenderCache();
 
         // hiding a widget make it lose focus
         if (!visible && isFocused()) {
@@ -1025,6 +1089,29 @@ void UIWidget::setVirtualOffset(const Point& offset)
         m_layout->update();
 }
 
+void UIWidget::setRenderCache(bool enabled)
+{
+    if (m_renderCache == enabled)
+        return;
+
+    m_renderCache = enabled;
+    m_renderCacheDirty = true;
+
+    if (!enabled && m_renderCacheFramebuffer) {
+        g_framebuffers.removeFrameBuffer(m_renderCacheFramebuffer);
+        m_renderCacheFramebuffer = nullptr;
+    }
+}
+
+void UIWidget::invalidateRenderCache()
+{
+    // a change anywhere inside a cached subtree must repaint it
+    for (UIWidget* widget = this; widget; widget = widget->m_parent.get()) {
+        if (widget->m_renderCache)
+            widget->m_renderCacheDirty = true;
+    }
+}
+
 bool UIWidget::isAnchored()
 {
     if (UIWidgetPtr parent = getParent())
@@ -1135,11 +1222,10 @@ UIWidgetPtr UIWidget::getChildBefore(const UIWidgetPtr& relativeChild)
 
 UIWidgetPtr UIWidget::getChildById(const std::string& childId)
 {
-    for (const UIWidgetPtr& child : m_children) {
-        if (child->getId() == childId)
-            return child;
-    }
-    return nullptr;
+    auto it = m_childrenById.find(childId);
+    if (it == m_childrenById.end())
+        return nullptr;
+    return it->second.first;
 }
 
 UIWidgetPtr UIWidget::getChildByPos(const Point& childPos)
@@ -1165,11 +1251,40 @@ UIWidgetPtr UIWidget::getChildByIndex(int index)
 }
 
 UIWidgetPtr UIWidget::recursiveGetChildById(const std::string& id)
+{
+    if (UIWidgetPtr widget = getChildById(id))
+        return widget;
+
+    const std::vector<UIWidget*>* widgets = g_ui.getWidgetsById(id);
+    if (!widgets)
+        return nullptr;
+
+    // the global index lists every widget with this id, only one of them is
+    // usually inside this subtree and checking that costs the widget depth,
+    // common ids such as list rows are cheaper to find by walking the subtree
+    const size_t maxIndexedCandidates = 8;
+    if (widgets->size() > maxIndexedCandidates)
+        return walkGetChildById(id);
+
+    UIWidget* found = nullptr;
+    for (UIWidget* widget : *widgets) {
+        if (!isAncestorOf(widget))
+            continue;
+
+        // ambiguous ids are resolved in the usual tree order
+        if (found)
+            return walkGetChildById(id);
+        found = widget;
+    }
+    return found ? found->static_self_cast<UIWidget>() : nullptr;
+}
+
+UIWidgetPtr UIWidget::walkGetChildById(const std::string& id)
 {
     UIWidgetPtr widget = getChildById(id);
     if (!widget) {
         for (const UIWidgetPtr& child : m_children) {
-            widget = child->recursiveGetChildById(id);
+            widget = child->walkGetChildById(id);
             if (widget)
                 break;
         }
@@ -1177,6 +1292,51 @@ UIWidgetPtr UIWidget::recursiveGetChildById(const std::string& id)
     return widget;
 }
 
+bool UIWidget::isAncestorOf(UIWidget* widget)
+{
+    for (UIWidget* parent = widget->m_parent.get(); parent; parent = parent->m_parent.get()) {
+        if (parent == this)
+            return true;
+    }
+    return false;
+}
+
+void UIWidget::indexChildId(const UIWidgetPtr& child, bool appended)
+{
+    ChildIdEntry& entry = m_childrenById[child->getId()];
+    if (++entry.count == 1)
+        entry.first = child;
+    else if (!appended)
+        reindexChildId(child->getId());
+}
+
+void UIWidget::unindexChildId(const UIWidgetPtr& child, const std::string& id)
+{
+    auto it = m_childrenById.find(id);
+    if (it == m_childrenById.end())
+        return;
+
+    if (--it->second.count == 0)
+        m_childrenById.erase(it);
+    else if (it->second.first == child)
+        reindexChildId(id);
+}
+
+void UIWidget::reindexChildId(const std::string& id)
+{
+    // children sharing an id are rare, the first one in order is the one found
+    auto it = m_childrenById.find(id);
+    if (it == m_childrenById.end())
+        return;
+
+    for (const UIWidgetPtr& child : m_children) {
+        if (child->getId() == id) {
+            it->second.first = child;
+            return;
+        }
+    }
+}
+
 UIWidgetPtr UIWidget::recursiveGetChildByPos(const Point& childPos, bool wantsPhantom)
 {
     if (!containsPaddingPoint(childPos))
@@ -1266,6 +1426,7 @@ bool UIWidget::setState(Fw::WidgetState state, bool on)
 
     if (oldStates != m_states) {
         updateStyle();
+        invalidateRenderCache();
         return true;
     }
     return false;
@@ -1490,6 +1651,7 @@ void UIWidget::onStyleApply(const std::string&, const OTMLNodePtr& styleNode)
     parseImageStyle(styleNode);
     parseTextStyle(styleNode);
 
+    invalidateRenderCache();
     g_app.repaint();
 }
 
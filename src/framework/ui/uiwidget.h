@@ -128,7 +128,7 @@ public:
     void setPhantom(bool phantom);
     void setDraggable(bool draggable);
     void setFixedSize(bool fixed);
-    void setClipping(bool clipping) { m_clipping = clipping; }
+    void setClipping(bool clipping) { m_clipping = clipping; invalidateRenderCache(); }
     void setLastFocusReason(Fw::FocusReason reason);
     void setAutoFocusPolicy(Fw::AutoFocusPolicy policy);
     void setAutoRepeatDelay(int delay) { m_autoRepeatDelay = delay; }
@@ -156,8 +156,35 @@ public:
     UIWidgetPtr backwardsGetWidgetById(const std::string& id);
 
 private:
+    struct ChildIdEntry {
+        UIWidgetPtr first;
+        int count = 0;
+    };
+
+    void indexChildId(const UIWidgetPtr& child, bool appended);
+    void unindexChildId(const UIWidgetPtr& child, const std::string& id);
+    void reindexChildId(const std::string& id);
+    bool isAncestorOf(UIWidget* widget);
+    UIWidgetPtr walkGetChildById(const std::string& id);
+
     stdext::boolean<false> m_updateEventScheduled;
     stdext::boolean<false> m_loadingStyle;
+    std::unordered_map<std::string, ChildIdEntry> m_childrenById;
+
+
+// render cache
+public:
+    void setRenderCache(bool enabled);
+    void invalidateRenderCache();
+    bool isRenderCached() { return m_renderCache; }
+
+private:
+    void drawRenderCache(const Rect& visibleRect);
+
+    stdext::boolean<false> m_renderCache;
+    stdext::boolean<true> m_renderCacheDirty;
+    stdext::boolean<false> m_renderCacheDrawing;
+    FrameBufferPtr m_renderCacheFramebuffer;
 
 
 // state managment
@@ -302,36 +329,36 @@ public:
     void setHeight(int height) { resize(getWidth(), height); }
     void setSize(const Size& size) { resize(size.width(), size.height()); }
     void setPosition(const Point& pos) { move(pos.x, pos.y); }
-    void setColor(const Color& color) { m_color = color; }
-    void setBackgroundColor(const Color& color) { m_backgroundColor = color; }
-    void setBackgroundOffsetX(int x) { m_backgroundRect.setX(x); }
-    void setBackgroundOffsetY(int y) { m_backgroundRect.setX(y); }
-    void setBackgroundOffset(const Point& pos) { m_backgroundRect.move(pos); }
-    void setBackgroundWidth(int width) { m_backgroundRect.setWidth(width); }
-    void setBackgroundHeight(int height) { m_backgroundRect.setHeight(height); }
-    void setBackgroundSize(const Size& size) { m_backgroundRect.resize(size); }
-    void setBackgroundRect(const Rect& rect) { m_backgroundRect = rect; }
+    void setColor(const Color& color) { m_color = color; invalidateRenderCache(); }
+    void setBackgroundColor(const Color& color) { m_backgroundColor = color; invalidateRenderCache(); }
+    void setBackgroundOffsetX(int x) { m_backgroundRect.setX(x); invalidateRenderCache(); }
+    void setBackgroundOffsetY(int y) { m_backgroundRect.setX(y); invalidateRenderCache(); }
+    void setBackgroundOffset(const Point& pos) { m_backgroundRect.move(pos); invalidateRenderCache(); }
+    void setBackgroundWidth(int width) { m_backgroundRect.setWidth(width); invalidateRenderCache(); }
+    void setBackgroundHeight(int height) { m_backgroundRect.setHeight(height); invalidateRenderCache(); }
+    void setBackgroundSize(const Size& size) { m_backgroundRect.resize(size); invalidateRenderCache(); }
+    void setBackgroundRect(const Rect& rect) { m_backgroundRect = rect; invalidateRenderCache(); }
     void setIcon(const std::string& iconFile);
-    void setIconColor(const Color& color) { m_iconColor = color; }
-    void setIconOffsetX(int x) { m_iconOffset.x = x; }
-    void setIconOffsetY(int y) { m_iconOffset.y = y; }
-    void setIconOffset(const Point& pos) { m_iconOffset = pos; }
-    void setIconWidth(int width) { m_iconRect.setWidth(width); }
-    void setIconHeight(int height) { m_iconRect.setHeight(height); }
-    void setIconSize(const Size& size) { m_iconRect.resize(size); }
-    void setIconRect(const Rect& rect) { m_iconRect = rect; }
-    void setIconClip(const Rect& rect) { m_iconClipRect = rect; }
-    void setIconAlign(Fw::AlignmentFlag align) { m_iconAlign = align; }
-    void setBorderWidth(int width) { m_borderWidth.set(width); updateLayout(); }
-    void setBorderWidthTop(int width) { m_borderWidth.top = width; }
-    void setBorderWidthRight(int width) { m_borderWidth.right = width; }
-    void setBorderWidthBottom(int width) { m_borderWidth.bottom = width; }
-    void setBorderWidthLeft(int width) { m_borderWidth.left = width; }
-    void setBorderColor(const Color& color) { m_borderColor.set(color); updateLayout(); }
-    void setBorderColorTop(const Color& color) { m_borderColor.top = color; }
-    void setBorderColorRight(const Color& color) { m_borderColor.right = color; }
-    void setBorderColorBottom(const Color& color) { m_borderColor.bottom = color; }
-    void setBorderColorLeft(const Color& color) { m_borderColor.left = color; }
+    void setIconColor(const Color& color) { m_iconColor = color; invalidateRenderCache(); }
+    void setIconOffsetX(int x) { m_iconOffset.x = x; invalidateRenderCache(); }
+    void setIconOffsetY(int y) { m_iconOffset.y = y; invalidateRenderCache(); }
+    void setIconOffset(const Point& pos) { m_iconOffset = pos; invalidateRenderCache(); }
+    void setIconWidth(int width) { m_iconRect.setWidth(width); invalidateRenderCache(); }
+    void setIconHeight(int height) { m_iconRect.setHeight(height); invalidateRenderCache(); }
+    void setIconSize(const Size& size) { m_iconRect.resize(size); invalidateRenderCache(); }
+    void setIconRect(const Rect& rect) { m_iconRect = rect; invalidateRenderCache(); }
+    void setIconClip(const Rect& rect) { m_iconClipRect = rect; invalidateRenderCache(); }
+    void setIconAlign(Fw::AlignmentFlag align) { m_iconAlign = align; invalidateRenderCache(); }
+    void setBorderWidth(int width) { m_borderWidth.set(width); updateLayout(); invalidateRenderCache(); }
+    void setBorderWidthTop(int width) { m_borderWidth.top = width; invalidateRenderCache(); }
+    void setBorderWidthRight(int width) { m_borderWidth.right = width; invalidateRenderCache(); }
+    void setBorderWidthBottom(int width) { m_borderWidth.bottom = width; invalidateRenderCache(); }
+    void setBorderWidthLeft(int width) { m_borderWidth.left = width; invalidateRenderCache(); }
+    void setBorderColor(const Color& color) { m_borderColor.set(color); updateLayout(); invalidateRenderCache(); }
+    void setBorderColorTop(const Color& color) { m_borderColor.top = color; invalidateRenderCache(); }
+    void setBorderColorRight(const Color& color) { m_borderColor.right = color; invalidateRenderCache(); }
+    void setBorderColorBottom(const Color& color) { m_borderColor.bottom = color; invalidateRenderCache(); }
+    void setBorderColorLeft(const Color& color) { m_borderColor.left = color; invalidateRenderCache(); }
     void setMargin(int margin) { m_margin.set(margin); updateParentLayout(); }
     void setMarginHorizontal(int margin) { m_margin.right = m_margin.left = margin; updateParentLayout(); }
     void setMarginVertical(int margin) { m_margin.bottom = m_margin.top = margin; updateParentLayout(); }
@@ -346,8 +373,8 @@ public:
     void setPaddingRight(int padding) { m_padding.right = padding; updateLayout(); }
     void setPaddingBottom(int padding) { m_padding.bottom = padding; updateLayout(); }
     void setPaddingLeft(int padding) { m_padding.left = padding; updateLayout(); }
-    void setOpacity(float opacity) { m_opacity = stdext::clamp<float>(opacity, 0.0f, 1.0f); }
-    void setRotation(float degrees) { m_rotation = degrees; }
+    void setOpacity(float opacity) { m_opacity = stdext::clamp<float>(opacity, 0.0f, 1.0f); invalidateRenderCache(); }
+    void setRotation(float degrees) { m_rotation = degrees; invalidateRenderCache(); }
 
     int getX() { return m_rect.x(); }
     int getY() { return m_rect.y(); }
@@ -400,7 +427,7 @@ private:
     void initImage();
     void parseImageStyle(const OTMLNodePtr& styleNode);
 
-    void updateImageCache() { m_imageMustRecache = true; }
+    void updateImageCache() { m_imageMustRecache = true; invalidateRenderCache(); }
     void configureBorderImage() { m_imageBordered = true; updateImageCache(); }
 
     CoordsBuffer m_imageCoordsBuffer;
@@ -435,7 +462,7 @@ public:
     void setImageColor(const Color& color) { m_imageColor = color; updateImageCache(); }
     void setImageFixedRatio(bool fixedRatio) { m_imageFixedRatio = fixedRatio; updateImageCache(); }
     void setImageRepeated(bool repeated) { m_imageRepeated = repeated; updateImageCache(); }
-    void setImageSmooth(bool smooth) { m_imageSmooth = smooth; }
+    void setImageSmooth(bool smooth) { m_imageSmooth = smooth; invalidateRenderCache(); }
     void setImageAutoResize(bool autoResize) { m_imageAutoResize = autoResize; }
     void setImageBorderTop(int border) { m_imageBorder.top = border; configureBorderImage(); }
     void setImageBorderRight(int border) { m_imageBorder.right = border; configureBorderImage(); }
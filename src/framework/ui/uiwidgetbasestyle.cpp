@@ -26,6 +26,7 @@
 #include "uigridlayout.h"
 #include "uianchorlayout.h"
 #include "uitranslator.h"
+#include "uimanager.h"
 
 #include <framework/graphics/painter.h>
 #include <framework/graphics/texture.h>
@@ -44,6 +45,7 @@ void UIWidget::initBaseStyle()
     // generate an unique id, this is need because anchored layouts find widgets by id
     static unsigned long id = 1;
     m_id = stdext::format("widget%d", id++);
+    g_ui.onWidgetIdChange(this, std::string(), m_id);
 }
 
 void UIWidget::parseBaseStyle(const OTMLNodePtr& styleNode)
@@ -152,6 +154,8 @@ void UIWidget::parseBaseStyle(const OTMLNodePtr& styleNode)
             setFixedSize(node->value<bool>());
         else if(node->tag() == "clipping")
             setClipping(node->value<bool>());
+        else if(node->tag() == "render-cache")
+            setRenderCache(node->value<bool>());
         else if(node->tag() == "border") {
             auto split = stdext::split(node->value(), " ");
             if(split.size() == 2) {
@@ -407,4 +411,5 @@ void UIWidget::setIcon(const std::string& iconFile)
         m_icon = g_textures.getTexture(iconFile);
     if(m_icon && !m_iconClipRect.isValid())
         m_iconClipRect = Rect(0, 0, m_icon->getSize());
+    invalidateRenderCache();
 }
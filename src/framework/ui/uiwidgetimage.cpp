@@ -192,5 +192,5 @@ void UIWidget::setImageSource(const std::string& source)
         setSize(size);
     }
 
-    m_imageMustRecache = true;
+    updateImageCache();
 }
@@ -54,6 +54,7 @@ void UIWidget::updateText()
     }
 
     m_textMustRecache = true;
+    invalidateRenderCache();
 }
 
 void UIWidget::parseTextStyle(const OTMLNodePtr& styleNode)